@@ -0,0 +1,63 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace {
+
+  std::size_t alignmentPadding(const unsigned char* base, std::size_t offset, std::size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(base) + offset;
+    return (alignment - address % alignment) % alignment;
+  }
+
+}
+
+namespace tekt {
+
+  FrameArena::FrameArena(std::size_t initialCapacity) {
+    addBlock(std::max<std::size_t>(initialCapacity, 1));
+  }
+
+  void* FrameArena::allocate(std::size_t size, std::size_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    while (true) {
+      auto& block = _blocks[_current];
+      auto padding = alignmentPadding(block.data.get(), _offset, alignment);
+      if (_offset + padding + size <= block.size) {
+        auto result = block.data.get() + _offset + padding;
+        _offset += padding + size;
+        return result;
+      }
+      _usedInFullBlocks += _offset;
+      _offset = 0;
+      if (_current + 1 == _blocks.size()) {
+        addBlock(std::max(size + alignment, block.size * 2));
+      }
+      _current++;
+    }
+  }
+
+  void FrameArena::reset() {
+    if (_blocks.size() > 1) {
+      auto total = capacity();
+      _blocks.clear();
+      addBlock(total);
+    }
+    _current = 0;
+    _offset = 0;
+    _usedInFullBlocks = 0;
+  }
+
+  std::size_t FrameArena::capacity() const {
+    std::size_t total = 0;
+    for (const auto& block : _blocks) {
+      total += block.size;
+    }
+    return total;
+  }
+
+  void FrameArena::addBlock(std::size_t minSize) {
+    _blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[minSize]), minSize });
+  }
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tekt {
+
+  /// A bump allocator for temporary data that only needs to live for one
+  /// cook. Allocating moves a pointer forward, freeing does nothing, and
+  /// reset() reclaims everything at once, typically at the start of execute().
+  ///
+  /// When a cook needs more than the current block, another block is added.
+  /// The next reset() replaces the blocks with a single one that is large
+  /// enough for all of them, so once the arena has seen the largest cook it
+  /// no longer touches the heap at all.
+  ///
+  /// The arena is not thread safe, and it never runs destructors.
+  class FrameArena {
+  public:
+    explicit FrameArena(std::size_t initialCapacity = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /// Returns uninitialized memory that stays valid until the next reset().
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /// Returns uninitialized storage for count values of type T.
+    template<typename T>
+    T* allocate(std::size_t count) {
+      return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+      static_assert(std::is_trivially_destructible_v<T>,
+                    "FrameArena doesn't run destructors");
+      return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// Releases everything that was allocated since the last reset.
+    void reset();
+
+    /// Bytes allocated since the last reset, including alignment padding.
+    std::size_t used() const { return _usedInFullBlocks + _offset; }
+    std::size_t capacity() const;
+  private:
+    struct Block {
+      std::unique_ptr<unsigned char[]> data;
+      std::size_t size;
+    };
+
+    void addBlock(std::size_t minSize);
+
+    std::vector<Block> _blocks;
+    std::size_t _current = 0;
+    std::size_t _offset = 0;
+    std::size_t _usedInFullBlocks = 0;
+  };
+
+  /// Adapts a FrameArena for use with standard containers. Memory given back
+  /// by the container is only reclaimed when the arena is reset, so this suits
+  /// containers that are built up during a cook and then dropped.
+  template<typename T>
+  class ArenaAllocator {
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) noexcept : _arena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(other.arena()) {}
+
+    T* allocate(std::size_t n) { return _arena->allocate<T>(n); }
+    void deallocate(T*, std::size_t) noexcept {}
+
+    FrameArena* arena() const noexcept { return _arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return _arena == other.arena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return _arena != other.arena(); }
+  private:
+    FrameArena* _arena;
+  };
+
+  template<typename T>
+  using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}
@@ -0,0 +1,142 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace {
+
+  // Set on the pool's worker threads, and on a thread that is inside run(),
+  // so that nested calls don't wait on the workers that are running them.
+  thread_local bool insidePool = false;
+
+  // Keep each thread's share on its own cache line, since all of the threads
+  // read the others' counters when looking for work to take.
+  constexpr std::size_t cacheLineSize = 64;
+
+}
+
+namespace tekt {
+
+  struct alignas(cacheLineSize) ThreadPool::Share {
+    std::atomic<int32_t> next{ 0 };
+    int32_t end = 0;
+  };
+
+  ThreadPool::ThreadPool(int workerCount) {
+    if (workerCount < 0) {
+      auto hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+      workerCount = std::max(hardwareThreads - 1, 0);
+    }
+    _shares.reset(new Share[workerCount + 1]);
+    _workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; i++) {
+      _workers.emplace_back(&ThreadPool::workerMain, this, i + 1);
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& worker : _workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  void ThreadPool::run(int32_t begin, int32_t end, RangeFunction fn, void* context, int32_t grain) {
+    assert(grain > 0);
+    if (end <= begin) {
+      return;
+    }
+    if (_workers.empty() || insidePool || end - begin <= grain) {
+      fn(begin, end, context);
+      return;
+    }
+
+    std::lock_guard<std::mutex> runLock(_runMutex);
+    insidePool = true;
+
+    // Chunks are counted from a multiple of grain so that their boundaries
+    // are aligned in sample terms, not just relative to begin. Several
+    // chunks per thread leave something to take for threads that finish
+    // early.
+    auto threads = threadCount();
+    auto chunkBase = begin - ((begin % grain) + grain) % grain;
+    auto perChunk = (end - begin) / (threads * 8);
+    auto chunkSize = std::max(grain, (perChunk + grain - 1) / grain * grain);
+    auto numChunks = (end - chunkBase + chunkSize - 1) / chunkSize;
+    for (int slot = 0; slot < threads; slot++) {
+      auto first = static_cast<int32_t>(static_cast<int64_t>(numChunks) * slot / threads);
+      auto last = static_cast<int32_t>(static_cast<int64_t>(numChunks) * (slot + 1) / threads);
+      _shares[slot].next.store(first, std::memory_order_relaxed);
+      _shares[slot].end = last;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _fn = fn;
+      _context = context;
+      _begin = begin;
+      _end = end;
+      _chunkBase = chunkBase;
+      _chunkSize = chunkSize;
+      _busy = static_cast<int>(_workers.size());
+      _generation++;
+    }
+    _wake.notify_all();
+
+    execute(0);
+
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _done.wait(lock, [this] { return _busy == 0; });
+    }
+    insidePool = false;
+  }
+
+  void ThreadPool::workerMain(int slot) {
+    insidePool = true;
+    uint64_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake.wait(lock, [&] { return _stopping || _generation != seen; });
+        if (_stopping) {
+          return;
+        }
+        seen = _generation;
+      }
+      execute(slot);
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_busy == 0) {
+          _done.notify_one();
+        }
+      }
+    }
+  }
+
+  void ThreadPool::execute(int slot) {
+    auto threads = threadCount();
+    for (int offset = 0; offset < threads; offset++) {
+      auto& share = _shares[(slot + offset) % threads];
+      while (true) {
+        auto chunk = share.next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= share.end) {
+          break;
+        }
+        auto chunkBegin = std::max(_begin, _chunkBase + chunk * _chunkSize);
+        auto chunkEnd = std::min(_end, _chunkBase + (chunk + 1) * _chunkSize);
+        _fn(chunkBegin, chunkEnd, _context);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tekt {
+
+  /// Samples are handed to the threads in multiples of this many, which keeps
+  /// threads writing to adjacent samples of a float channel on separate cache
+  /// lines.
+  constexpr int32_t parallelGrain = 16;
+
+  /// A set of worker threads that stay alive between cooks, for splitting a
+  /// loop over samples across cores.
+  ///
+  /// Each call to run() gives every thread a contiguous share of the range,
+  /// which it works through a chunk at a time. Threads that finish early take
+  /// chunks from the others' shares.
+  class ThreadPool {
+  public:
+    using RangeFunction = void (*)(int32_t begin, int32_t end, void* context);
+
+    /// Creates a pool with the given number of worker threads. The thread that
+    /// calls run() also does work, so a pool with no workers runs everything
+    /// on the calling thread. A negative count uses one worker for each
+    /// hardware thread other than the calling one.
+    explicit ThreadPool(int workerCount = -1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// The pool used by parallelFor().
+    static ThreadPool& shared();
+
+    /// Number of threads that run() uses, including the calling thread.
+    int threadCount() const { return static_cast<int>(_workers.size()) + 1; }
+
+    /// Calls fn for sub-ranges that together cover [begin, end), and returns
+    /// once all of them are done. Sub-range boundaries fall on multiples of
+    /// grain. fn must not throw. Calls made from inside fn run serially on
+    /// the calling thread.
+    void run(int32_t begin, int32_t end, RangeFunction fn, void* context,
+             int32_t grain = parallelGrain);
+  private:
+    struct Share;
+
+    void workerMain(int slot);
+    void execute(int slot);
+
+    std::vector<std::thread> _workers;
+    std::unique_ptr<Share[]> _shares;
+
+    // Serializes calls to run() from different threads.
+    std::mutex _runMutex;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    uint64_t _generation = 0;
+    int _busy = 0;
+    bool _stopping = false;
+
+    RangeFunction _fn = nullptr;
+    void* _context = nullptr;
+    int32_t _begin = 0;
+    int32_t _end = 0;
+    int32_t _chunkBase = 0;
+    int32_t _chunkSize = 0;
+  };
+
+  /// Calls body(begin, end) for sub-ranges of samples on the shared pool.
+  /// Bound InputChannels can be read and bound OutputChannels written from
+  /// the body, as long as each call only writes to samples in its own range.
+  template<typename F>
+  void parallelForRange(int32_t begin, int32_t end, F&& body, int32_t grain = parallelGrain) {
+    using Body = std::remove_reference_t<F>;
+    ThreadPool::shared().run(
+      begin, end,
+      [](int32_t b, int32_t e, void* context) {
+        (*static_cast<Body*>(context))(b, e);
+      },
+      const_cast<void*>(static_cast<const void*>(&body)),
+      grain);
+  }
+
+  /// Calls body(i) for each sample in [begin, end) on the shared pool, as a
+  /// drop-in replacement for a plain loop over the samples.
+  template<typename F>
+  void parallelFor(int32_t begin, int32_t end, F&& body, int32_t grain = parallelGrain) {
+    parallelForRange(begin, end, [&body](int32_t b, int32_t e) {
+      for (int32_t i = b; i < e; i++) {
+        body(i);
+      }
+    }, grain);
+  }
+
+}
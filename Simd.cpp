@@ -0,0 +1,845 @@
+#include "Simd.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(_M_X64) || defined(__x86_64__)
+  #define TEKT_SIMD_X86
+  #include <immintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+    #define TEKT_TARGET_AVX
+  #else
+    #define TEKT_TARGET_AVX __attribute__((target("avx")))
+  #endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+  #define TEKT_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+namespace {
+
+  struct Kernels {
+    void (*interleave3)(const float* x, const float* y, const float* z, float* dest, std::size_t count);
+    void (*interleave4)(const float* x, const float* y, const float* z, const float* w, float* dest, std::size_t count);
+    void (*deinterleave3)(const float* src, float* x, float* y, float* z, std::size_t count);
+    void (*deinterleave4)(const float* src, float* x, float* y, float* z, float* w, std::size_t count);
+    void (*remap)(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms);
+    void (*normalize)(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms);
+    void (*scale)(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms);
+    void (*summarize)(const float* src, std::size_t count, tekt::impl::SampleSummary& summary);
+    void (*deviations)(const float* src, std::size_t count, float center, float& sum, float& sumSquares);
+  };
+
+  // The remap kernels use the same sequence of operations as the scalar
+  // tekt::remap(), rather than a folded multiply-add, so that their results
+  // are bit-identical to it.
+
+  inline float clampScalar(float value, const tekt::impl::RemapTerms& terms) {
+    if (value > terms.high) return terms.high;
+    if (value < terms.low) return terms.low;
+    return value;
+  }
+
+  void interleave3Scalar(const float* x, const float* y, const float* z, float* dest, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+      dest[i * 3 + 0] = x[i];
+      dest[i * 3 + 1] = y[i];
+      dest[i * 3 + 2] = z[i];
+    }
+  }
+
+  void interleave4Scalar(const float* x, const float* y, const float* z, const float* w, float* dest, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+      dest[i * 4 + 0] = x[i];
+      dest[i * 4 + 1] = y[i];
+      dest[i * 4 + 2] = z[i];
+      dest[i * 4 + 3] = w[i];
+    }
+  }
+
+  void deinterleave3Scalar(const float* src, float* x, float* y, float* z, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+      x[i] = src[i * 3 + 0];
+      y[i] = src[i * 3 + 1];
+      z[i] = src[i * 3 + 2];
+    }
+  }
+
+  void deinterleave4Scalar(const float* src, float* x, float* y, float* z, float* w, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+      x[i] = src[i * 4 + 0];
+      y[i] = src[i * 4 + 1];
+      z[i] = src[i * 4 + 2];
+      w[i] = src[i * 4 + 3];
+    }
+  }
+
+  void remapScalar(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    for (std::size_t i = 0; i < count; i++) {
+      float value = (src[i] - terms.inputMin) / terms.inputSpan * terms.outputSpan + terms.outputMin;
+      dest[i] = terms.clamp ? clampScalar(value, terms) : value;
+    }
+  }
+
+  void normalizeScalar(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    for (std::size_t i = 0; i < count; i++) {
+      dest[i] = (src[i] - terms.inputMin) / terms.inputSpan;
+    }
+  }
+
+  void scaleScalar(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    for (std::size_t i = 0; i < count; i++) {
+      float value = src[i] * terms.outputSpan + terms.outputMin;
+      dest[i] = terms.clamp ? clampScalar(value, terms) : value;
+    }
+  }
+
+  void summarizeScalar(const float* src, std::size_t count, tekt::impl::SampleSummary& summary) {
+    for (std::size_t i = 0; i < count; i++) {
+      if (src[i] < summary.min) summary.min = src[i];
+      if (src[i] > summary.max) summary.max = src[i];
+      summary.sum += src[i];
+    }
+  }
+
+  void deviationsScalar(const float* src, std::size_t count, float center, float& sum, float& sumSquares) {
+    for (std::size_t i = 0; i < count; i++) {
+      float d = src[i] - center;
+      sum += d;
+      sumSquares += d * d;
+    }
+  }
+
+  const Kernels scalarKernels = {
+    interleave3Scalar,
+    interleave4Scalar,
+    deinterleave3Scalar,
+    deinterleave4Scalar,
+    remapScalar,
+    normalizeScalar,
+    scaleScalar,
+    summarizeScalar,
+    deviationsScalar,
+  };
+
+#ifdef TEKT_SIMD_X86
+
+  // The 3-component shuffles follow the approach from Intel's "3D Vector
+  // Normalization Using 256-Bit Intel AVX" paper, applied per 128-bit lane.
+
+  void interleave3SSE2(const float* x, const float* y, const float* z, float* dest, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 vx = _mm_loadu_ps(x + i);
+      __m128 vy = _mm_loadu_ps(y + i);
+      __m128 vz = _mm_loadu_ps(z + i);
+      __m128 rxy = _mm_shuffle_ps(vx, vy, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 ryz = _mm_shuffle_ps(vy, vz, _MM_SHUFFLE(3, 1, 3, 1));
+      __m128 rzx = _mm_shuffle_ps(vz, vx, _MM_SHUFFLE(3, 1, 2, 0));
+      float* out = dest + i * 3;
+      _mm_storeu_ps(out + 0, _mm_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(out + 4, _mm_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0)));
+      _mm_storeu_ps(out + 8, _mm_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    interleave3Scalar(x + i, y + i, z + i, dest + i * 3, count - i);
+  }
+
+  void deinterleave3SSE2(const float* src, float* x, float* y, float* z, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      const float* in = src + i * 3;
+      __m128 m0 = _mm_loadu_ps(in + 0);
+      __m128 m1 = _mm_loadu_ps(in + 4);
+      __m128 m2 = _mm_loadu_ps(in + 8);
+      __m128 xy = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+      __m128 yz = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+      _mm_storeu_ps(x + i, _mm_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0)));
+      _mm_storeu_ps(y + i, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+      _mm_storeu_ps(z + i, _mm_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1)));
+    }
+    deinterleave3Scalar(src + i * 3, x + i, y + i, z + i, count - i);
+  }
+
+  void interleave4SSE2(const float* x, const float* y, const float* z, const float* w, float* dest, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 r0 = _mm_loadu_ps(x + i);
+      __m128 r1 = _mm_loadu_ps(y + i);
+      __m128 r2 = _mm_loadu_ps(z + i);
+      __m128 r3 = _mm_loadu_ps(w + i);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      float* out = dest + i * 4;
+      _mm_storeu_ps(out + 0, r0);
+      _mm_storeu_ps(out + 4, r1);
+      _mm_storeu_ps(out + 8, r2);
+      _mm_storeu_ps(out + 12, r3);
+    }
+    interleave4Scalar(x + i, y + i, z + i, w + i, dest + i * 4, count - i);
+  }
+
+  void deinterleave4SSE2(const float* src, float* x, float* y, float* z, float* w, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      const float* in = src + i * 4;
+      __m128 r0 = _mm_loadu_ps(in + 0);
+      __m128 r1 = _mm_loadu_ps(in + 4);
+      __m128 r2 = _mm_loadu_ps(in + 8);
+      __m128 r3 = _mm_loadu_ps(in + 12);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _mm_storeu_ps(x + i, r0);
+      _mm_storeu_ps(y + i, r1);
+      _mm_storeu_ps(z + i, r2);
+      _mm_storeu_ps(w + i, r3);
+    }
+    deinterleave4Scalar(src + i * 4, x + i, y + i, z + i, w + i, count - i);
+  }
+
+  // The operand order of min/max is chosen so that a NaN passes through
+  // unclamped, the same as it does in the scalar comparisons.
+
+  void remapSSE2(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const __m128 inputMin = _mm_set1_ps(terms.inputMin);
+    const __m128 inputSpan = _mm_set1_ps(terms.inputSpan);
+    const __m128 outputSpan = _mm_set1_ps(terms.outputSpan);
+    const __m128 outputMin = _mm_set1_ps(terms.outputMin);
+    const __m128 low = _mm_set1_ps(terms.low);
+    const __m128 high = _mm_set1_ps(terms.high);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 v = _mm_loadu_ps(src + i);
+      v = _mm_add_ps(_mm_mul_ps(_mm_div_ps(_mm_sub_ps(v, inputMin), inputSpan), outputSpan), outputMin);
+      if (terms.clamp) {
+        v = _mm_max_ps(low, _mm_min_ps(high, v));
+      }
+      _mm_storeu_ps(dest + i, v);
+    }
+    remapScalar(src + i, dest + i, count - i, terms);
+  }
+
+  void normalizeSSE2(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const __m128 inputMin = _mm_set1_ps(terms.inputMin);
+    const __m128 inputSpan = _mm_set1_ps(terms.inputSpan);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(src + i), inputMin), inputSpan));
+    }
+    normalizeScalar(src + i, dest + i, count - i, terms);
+  }
+
+  void scaleSSE2(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const __m128 outputSpan = _mm_set1_ps(terms.outputSpan);
+    const __m128 outputMin = _mm_set1_ps(terms.outputMin);
+    const __m128 low = _mm_set1_ps(terms.low);
+    const __m128 high = _mm_set1_ps(terms.high);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), outputSpan), outputMin);
+      if (terms.clamp) {
+        v = _mm_max_ps(low, _mm_min_ps(high, v));
+      }
+      _mm_storeu_ps(dest + i, v);
+    }
+    scaleScalar(src + i, dest + i, count - i, terms);
+  }
+
+  // The accumulator is the second operand of min/max, which is the one that
+  // they return when either is NaN, so NaNs are skipped as in the scalar
+  // comparisons.
+
+  void summarizeSSE2(const float* src, std::size_t count, tekt::impl::SampleSummary& summary) {
+    std::size_t i = 0;
+    if (count >= 4) {
+      __m128 lo = _mm_set1_ps(summary.min);
+      __m128 hi = _mm_set1_ps(summary.max);
+      __m128 sum = _mm_setzero_ps();
+      for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(src + i);
+        lo = _mm_min_ps(v, lo);
+        hi = _mm_max_ps(v, hi);
+        sum = _mm_add_ps(sum, v);
+      }
+      alignas(16) float lanes[3][4];
+      _mm_store_ps(lanes[0], lo);
+      _mm_store_ps(lanes[1], hi);
+      _mm_store_ps(lanes[2], sum);
+      for (int lane = 0; lane < 4; lane++) {
+        summary.min = std::min(summary.min, lanes[0][lane]);
+        summary.max = std::max(summary.max, lanes[1][lane]);
+        summary.sum += lanes[2][lane];
+      }
+    }
+    summarizeScalar(src + i, count - i, summary);
+  }
+
+  void deviationsSSE2(const float* src, std::size_t count, float center, float& sum, float& sumSquares) {
+    std::size_t i = 0;
+    if (count >= 4) {
+      const __m128 c = _mm_set1_ps(center);
+      __m128 s = _mm_setzero_ps();
+      __m128 sq = _mm_setzero_ps();
+      for (; i + 4 <= count; i += 4) {
+        __m128 d = _mm_sub_ps(_mm_loadu_ps(src + i), c);
+        s = _mm_add_ps(s, d);
+        sq = _mm_add_ps(sq, _mm_mul_ps(d, d));
+      }
+      alignas(16) float lanes[2][4];
+      _mm_store_ps(lanes[0], s);
+      _mm_store_ps(lanes[1], sq);
+      for (int lane = 0; lane < 4; lane++) {
+        sum += lanes[0][lane];
+        sumSquares += lanes[1][lane];
+      }
+    }
+    deviationsScalar(src + i, count - i, center, sum, sumSquares);
+  }
+
+  const Kernels sse2Kernels = {
+    interleave3SSE2,
+    interleave4SSE2,
+    deinterleave3SSE2,
+    deinterleave4SSE2,
+    remapSSE2,
+    normalizeSSE2,
+    scaleSSE2,
+    summarizeSSE2,
+    deviationsSSE2,
+  };
+
+  TEKT_TARGET_AVX
+  void interleave3AVX(const float* x, const float* y, const float* z, float* dest, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m256 vx = _mm256_loadu_ps(x + i);
+      __m256 vy = _mm256_loadu_ps(y + i);
+      __m256 vz = _mm256_loadu_ps(z + i);
+      __m256 rxy = _mm256_shuffle_ps(vx, vy, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 ryz = _mm256_shuffle_ps(vy, vz, _MM_SHUFFLE(3, 1, 3, 1));
+      __m256 rzx = _mm256_shuffle_ps(vz, vx, _MM_SHUFFLE(3, 1, 2, 0));
+      // Each 128-bit lane now holds 4 vectors: lane 0 has 0-3, lane 1 has 4-7.
+      __m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+      __m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+      float* out = dest + i * 3;
+      _mm256_storeu_ps(out + 0, _mm256_permute2f128_ps(r03, r14, 0x20));
+      _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(r25, r03, 0x30));
+      _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(r14, r25, 0x31));
+    }
+    // The compiler omits vzeroupper when the tail is a sibling call, which
+    // makes every legacy SSE instruction in it pay a transition penalty.
+    _mm256_zeroupper();
+    interleave3SSE2(x + i, y + i, z + i, dest + i * 3, count - i);
+  }
+
+  TEKT_TARGET_AVX
+  void deinterleave3AVX(const float* src, float* x, float* y, float* z, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      const float* in = src + i * 3;
+      __m256 m03 = _mm256_castps128_ps256(_mm_loadu_ps(in + 0));
+      __m256 m14 = _mm256_castps128_ps256(_mm_loadu_ps(in + 4));
+      __m256 m25 = _mm256_castps128_ps256(_mm_loadu_ps(in + 8));
+      m03 = _mm256_insertf128_ps(m03, _mm_loadu_ps(in + 12), 1);
+      m14 = _mm256_insertf128_ps(m14, _mm_loadu_ps(in + 16), 1);
+      m25 = _mm256_insertf128_ps(m25, _mm_loadu_ps(in + 20), 1);
+      __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+      __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+      _mm256_storeu_ps(x + i, _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0)));
+      _mm256_storeu_ps(y + i, _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+      _mm256_storeu_ps(z + i, _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1)));
+    }
+    _mm256_zeroupper();
+    deinterleave3SSE2(src + i * 3, x + i, y + i, z + i, count - i);
+  }
+
+  TEKT_TARGET_AVX
+  void interleave4AVX(const float* x, const float* y, const float* z, const float* w, float* dest, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m256 vx = _mm256_loadu_ps(x + i);
+      __m256 vy = _mm256_loadu_ps(y + i);
+      __m256 vz = _mm256_loadu_ps(z + i);
+      __m256 vw = _mm256_loadu_ps(w + i);
+      __m256 t0 = _mm256_unpacklo_ps(vx, vy);
+      __m256 t1 = _mm256_unpackhi_ps(vx, vy);
+      __m256 t2 = _mm256_unpacklo_ps(vz, vw);
+      __m256 t3 = _mm256_unpackhi_ps(vz, vw);
+      // c0 holds tuples 0 and 4, c1 holds 1 and 5, and so on.
+      __m256 c0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+      __m256 c1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+      __m256 c2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+      __m256 c3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+      float* out = dest + i * 4;
+      _mm256_storeu_ps(out + 0, _mm256_permute2f128_ps(c0, c1, 0x20));
+      _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(c2, c3, 0x20));
+      _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(c0, c1, 0x31));
+      _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(c2, c3, 0x31));
+    }
+    _mm256_zeroupper();
+    interleave4SSE2(x + i, y + i, z + i, w + i, dest + i * 4, count - i);
+  }
+
+  TEKT_TARGET_AVX
+  void deinterleave4AVX(const float* src, float* x, float* y, float* z, float* w, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      const float* in = src + i * 4;
+      __m256 m0 = _mm256_loadu_ps(in + 0);
+      __m256 m1 = _mm256_loadu_ps(in + 8);
+      __m256 m2 = _mm256_loadu_ps(in + 16);
+      __m256 m3 = _mm256_loadu_ps(in + 24);
+      // Regroup so that lane 0 holds tuples 0-3 and lane 1 holds tuples 4-7.
+      __m256 a0 = _mm256_permute2f128_ps(m0, m2, 0x20);
+      __m256 a1 = _mm256_permute2f128_ps(m0, m2, 0x31);
+      __m256 a2 = _mm256_permute2f128_ps(m1, m3, 0x20);
+      __m256 a3 = _mm256_permute2f128_ps(m1, m3, 0x31);
+      __m256 t0 = _mm256_unpacklo_ps(a0, a1);
+      __m256 t1 = _mm256_unpacklo_ps(a2, a3);
+      __m256 t2 = _mm256_unpackhi_ps(a0, a1);
+      __m256 t3 = _mm256_unpackhi_ps(a2, a3);
+      _mm256_storeu_ps(x + i, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)));
+      _mm256_storeu_ps(y + i, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)));
+      _mm256_storeu_ps(z + i, _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)));
+      _mm256_storeu_ps(w + i, _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2)));
+    }
+    _mm256_zeroupper();
+    deinterleave4SSE2(src + i * 4, x + i, y + i, z + i, w + i, count - i);
+  }
+
+  TEKT_TARGET_AVX
+  void remapAVX(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const __m256 inputMin = _mm256_set1_ps(terms.inputMin);
+    const __m256 inputSpan = _mm256_set1_ps(terms.inputSpan);
+    const __m256 outputSpan = _mm256_set1_ps(terms.outputSpan);
+    const __m256 outputMin = _mm256_set1_ps(terms.outputMin);
+    const __m256 low = _mm256_set1_ps(terms.low);
+    const __m256 high = _mm256_set1_ps(terms.high);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m256 v = _mm256_loadu_ps(src + i);
+      v = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(_mm256_sub_ps(v, inputMin), inputSpan), outputSpan), outputMin);
+      if (terms.clamp) {
+        v = _mm256_max_ps(low, _mm256_min_ps(high, v));
+      }
+      _mm256_storeu_ps(dest + i, v);
+    }
+    _mm256_zeroupper();
+    remapSSE2(src + i, dest + i, count - i, terms);
+  }
+
+  TEKT_TARGET_AVX
+  void normalizeAVX(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const __m256 inputMin = _mm256_set1_ps(terms.inputMin);
+    const __m256 inputSpan = _mm256_set1_ps(terms.inputSpan);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      _mm256_storeu_ps(dest + i, _mm256_div_ps(_mm256_sub_ps(_mm256_loadu_ps(src + i), inputMin), inputSpan));
+    }
+    _mm256_zeroupper();
+    normalizeSSE2(src + i, dest + i, count - i, terms);
+  }
+
+  TEKT_TARGET_AVX
+  void scaleAVX(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const __m256 outputSpan = _mm256_set1_ps(terms.outputSpan);
+    const __m256 outputMin = _mm256_set1_ps(terms.outputMin);
+    const __m256 low = _mm256_set1_ps(terms.low);
+    const __m256 high = _mm256_set1_ps(terms.high);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), outputSpan), outputMin);
+      if (terms.clamp) {
+        v = _mm256_max_ps(low, _mm256_min_ps(high, v));
+      }
+      _mm256_storeu_ps(dest + i, v);
+    }
+    _mm256_zeroupper();
+    scaleSSE2(src + i, dest + i, count - i, terms);
+  }
+
+  TEKT_TARGET_AVX
+  void summarizeAVX(const float* src, std::size_t count, tekt::impl::SampleSummary& summary) {
+    std::size_t i = 0;
+    if (count >= 8) {
+      __m256 lo = _mm256_set1_ps(summary.min);
+      __m256 hi = _mm256_set1_ps(summary.max);
+      __m256 sum = _mm256_setzero_ps();
+      for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(src + i);
+        lo = _mm256_min_ps(v, lo);
+        hi = _mm256_max_ps(v, hi);
+        sum = _mm256_add_ps(sum, v);
+      }
+      alignas(32) float lanes[3][8];
+      _mm256_store_ps(lanes[0], lo);
+      _mm256_store_ps(lanes[1], hi);
+      _mm256_store_ps(lanes[2], sum);
+      for (int lane = 0; lane < 8; lane++) {
+        summary.min = std::min(summary.min, lanes[0][lane]);
+        summary.max = std::max(summary.max, lanes[1][lane]);
+        summary.sum += lanes[2][lane];
+      }
+    }
+    _mm256_zeroupper();
+    summarizeScalar(src + i, count - i, summary);
+  }
+
+  TEKT_TARGET_AVX
+  void deviationsAVX(const float* src, std::size_t count, float center, float& sum, float& sumSquares) {
+    std::size_t i = 0;
+    if (count >= 8) {
+      const __m256 c = _mm256_set1_ps(center);
+      __m256 s = _mm256_setzero_ps();
+      __m256 sq = _mm256_setzero_ps();
+      for (; i + 8 <= count; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(src + i), c);
+        s = _mm256_add_ps(s, d);
+        sq = _mm256_add_ps(sq, _mm256_mul_ps(d, d));
+      }
+      alignas(32) float lanes[2][8];
+      _mm256_store_ps(lanes[0], s);
+      _mm256_store_ps(lanes[1], sq);
+      for (int lane = 0; lane < 8; lane++) {
+        sum += lanes[0][lane];
+        sumSquares += lanes[1][lane];
+      }
+    }
+    _mm256_zeroupper();
+    deviationsScalar(src + i, count - i, center, sum, sumSquares);
+  }
+
+  const Kernels avxKernels = {
+    interleave3AVX,
+    interleave4AVX,
+    deinterleave3AVX,
+    deinterleave4AVX,
+    remapAVX,
+    normalizeAVX,
+    scaleAVX,
+    summarizeAVX,
+    deviationsAVX,
+  };
+
+  bool cpuSupportsAVX() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    // The OS also has to save the upper halves of the registers.
+    return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+  }
+
+#endif
+
+#ifdef TEKT_SIMD_NEON
+
+  void interleave3NEON(const float* x, const float* y, const float* z, float* dest, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      float32x4x3_t v;
+      v.val[0] = vld1q_f32(x + i);
+      v.val[1] = vld1q_f32(y + i);
+      v.val[2] = vld1q_f32(z + i);
+      vst3q_f32(dest + i * 3, v);
+    }
+    interleave3Scalar(x + i, y + i, z + i, dest + i * 3, count - i);
+  }
+
+  void interleave4NEON(const float* x, const float* y, const float* z, const float* w, float* dest, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      float32x4x4_t v;
+      v.val[0] = vld1q_f32(x + i);
+      v.val[1] = vld1q_f32(y + i);
+      v.val[2] = vld1q_f32(z + i);
+      v.val[3] = vld1q_f32(w + i);
+      vst4q_f32(dest + i * 4, v);
+    }
+    interleave4Scalar(x + i, y + i, z + i, w + i, dest + i * 4, count - i);
+  }
+
+  void deinterleave3NEON(const float* src, float* x, float* y, float* z, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      float32x4x3_t v = vld3q_f32(src + i * 3);
+      vst1q_f32(x + i, v.val[0]);
+      vst1q_f32(y + i, v.val[1]);
+      vst1q_f32(z + i, v.val[2]);
+    }
+    deinterleave3Scalar(src + i * 3, x + i, y + i, z + i, count - i);
+  }
+
+  void deinterleave4NEON(const float* src, float* x, float* y, float* z, float* w, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      float32x4x4_t v = vld4q_f32(src + i * 4);
+      vst1q_f32(x + i, v.val[0]);
+      vst1q_f32(y + i, v.val[1]);
+      vst1q_f32(z + i, v.val[2]);
+      vst1q_f32(w + i, v.val[3]);
+    }
+    deinterleave4Scalar(src + i * 4, x + i, y + i, z + i, w + i, count - i);
+  }
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+  // vminq/vmaxq return NaN if either operand is NaN, so a NaN passes through
+  // unclamped, the same as it does in the scalar comparisons.
+
+  void remapNEON(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const float32x4_t inputMin = vdupq_n_f32(terms.inputMin);
+    const float32x4_t inputSpan = vdupq_n_f32(terms.inputSpan);
+    const float32x4_t outputSpan = vdupq_n_f32(terms.outputSpan);
+    const float32x4_t outputMin = vdupq_n_f32(terms.outputMin);
+    const float32x4_t low = vdupq_n_f32(terms.low);
+    const float32x4_t high = vdupq_n_f32(terms.high);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      float32x4_t v = vld1q_f32(src + i);
+      v = vaddq_f32(vmulq_f32(vdivq_f32(vsubq_f32(v, inputMin), inputSpan), outputSpan), outputMin);
+      if (terms.clamp) {
+        v = vmaxq_f32(low, vminq_f32(high, v));
+      }
+      vst1q_f32(dest + i, v);
+    }
+    remapScalar(src + i, dest + i, count - i, terms);
+  }
+
+  void normalizeNEON(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const float32x4_t inputMin = vdupq_n_f32(terms.inputMin);
+    const float32x4_t inputSpan = vdupq_n_f32(terms.inputSpan);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      vst1q_f32(dest + i, vdivq_f32(vsubq_f32(vld1q_f32(src + i), inputMin), inputSpan));
+    }
+    normalizeScalar(src + i, dest + i, count - i, terms);
+  }
+
+  void scaleNEON(const float* src, float* dest, std::size_t count, const tekt::impl::RemapTerms& terms) {
+    const float32x4_t outputSpan = vdupq_n_f32(terms.outputSpan);
+    const float32x4_t outputMin = vdupq_n_f32(terms.outputMin);
+    const float32x4_t low = vdupq_n_f32(terms.low);
+    const float32x4_t high = vdupq_n_f32(terms.high);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      float32x4_t v = vaddq_f32(vmulq_f32(vld1q_f32(src + i), outputSpan), outputMin);
+      if (terms.clamp) {
+        v = vmaxq_f32(low, vminq_f32(high, v));
+      }
+      vst1q_f32(dest + i, v);
+    }
+    scaleScalar(src + i, dest + i, count - i, terms);
+  }
+
+  // vminnmq/vmaxnmq return the other operand when one is NaN, so NaNs are
+  // skipped as in the scalar comparisons.
+
+  void summarizeNEON(const float* src, std::size_t count, tekt::impl::SampleSummary& summary) {
+    std::size_t i = 0;
+    if (count >= 4) {
+      float32x4_t lo = vdupq_n_f32(summary.min);
+      float32x4_t hi = vdupq_n_f32(summary.max);
+      float32x4_t sum = vdupq_n_f32(0.0f);
+      for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(src + i);
+        lo = vminnmq_f32(lo, v);
+        hi = vmaxnmq_f32(hi, v);
+        sum = vaddq_f32(sum, v);
+      }
+      summary.min = vminnmvq_f32(lo);
+      summary.max = vmaxnmvq_f32(hi);
+      summary.sum += vaddvq_f32(sum);
+    }
+    summarizeScalar(src + i, count - i, summary);
+  }
+
+  void deviationsNEON(const float* src, std::size_t count, float center, float& sum, float& sumSquares) {
+    std::size_t i = 0;
+    if (count >= 4) {
+      const float32x4_t c = vdupq_n_f32(center);
+      float32x4_t s = vdupq_n_f32(0.0f);
+      float32x4_t sq = vdupq_n_f32(0.0f);
+      for (; i + 4 <= count; i += 4) {
+        float32x4_t d = vsubq_f32(vld1q_f32(src + i), c);
+        s = vaddq_f32(s, d);
+        sq = vfmaq_f32(sq, d, d);
+      }
+      sum += vaddvq_f32(s);
+      sumSquares += vaddvq_f32(sq);
+    }
+    deviationsScalar(src + i, count - i, center, sum, sumSquares);
+  }
+
+#else
+
+  // 32-bit ARM has no vector divide, so the remap kernels stay scalar there,
+  // and neither does it have the NaN-skipping min/max used for the summaries.
+  const auto remapNEON = remapScalar;
+  const auto normalizeNEON = normalizeScalar;
+  const auto scaleNEON = scaleScalar;
+  const auto summarizeNEON = summarizeScalar;
+  const auto deviationsNEON = deviationsScalar;
+
+#endif
+
+  const Kernels neonKernels = {
+    interleave3NEON,
+    interleave4NEON,
+    deinterleave3NEON,
+    deinterleave4NEON,
+    remapNEON,
+    normalizeNEON,
+    scaleNEON,
+    summarizeNEON,
+    deviationsNEON,
+  };
+
+#endif
+
+  bool isSupported(tekt::SimdLevel level) {
+    switch (level) {
+      case tekt::SimdLevel::Scalar:
+        return true;
+#ifdef TEKT_SIMD_X86
+      case tekt::SimdLevel::SSE2:
+        return true;
+      case tekt::SimdLevel::AVX:
+        return cpuSupportsAVX();
+#endif
+#ifdef TEKT_SIMD_NEON
+      case tekt::SimdLevel::NEON:
+        return true;
+#endif
+      default:
+        return false;
+    }
+  }
+
+  const Kernels& kernelsFor(tekt::SimdLevel level) {
+    switch (level) {
+#ifdef TEKT_SIMD_X86
+      case tekt::SimdLevel::SSE2:
+        return sse2Kernels;
+      case tekt::SimdLevel::AVX:
+        return avxKernels;
+#endif
+#ifdef TEKT_SIMD_NEON
+      case tekt::SimdLevel::NEON:
+        return neonKernels;
+#endif
+      default:
+        return scalarKernels;
+    }
+  }
+
+  std::atomic<tekt::SimdLevel> currentLevel{ tekt::SimdLevel::Scalar };
+  std::atomic<const Kernels*> currentKernels{ nullptr };
+
+  const Kernels& kernels() {
+    auto k = currentKernels.load(std::memory_order_acquire);
+    if (k == nullptr) {
+      auto level = tekt::detectSimdLevel();
+      k = &kernelsFor(level);
+      currentLevel.store(level, std::memory_order_relaxed);
+      currentKernels.store(k, std::memory_order_release);
+    }
+    return *k;
+  }
+
+}
+
+namespace tekt {
+
+  SimdLevel detectSimdLevel() {
+    if (isSupported(SimdLevel::AVX)) return SimdLevel::AVX;
+    if (isSupported(SimdLevel::SSE2)) return SimdLevel::SSE2;
+    if (isSupported(SimdLevel::NEON)) return SimdLevel::NEON;
+    return SimdLevel::Scalar;
+  }
+
+  SimdLevel simdLevel() {
+    kernels();
+    return currentLevel.load(std::memory_order_relaxed);
+  }
+
+  void setSimdLevel(SimdLevel level) {
+    if (!isSupported(level)) {
+      level = detectSimdLevel();
+    }
+    currentLevel.store(level, std::memory_order_relaxed);
+    currentKernels.store(&kernelsFor(level), std::memory_order_release);
+  }
+
+  const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+      case SimdLevel::SSE2: return "SSE2";
+      case SimdLevel::AVX: return "AVX";
+      case SimdLevel::NEON: return "NEON";
+      default: return "Scalar";
+    }
+  }
+
+  void interleave(const float* x, const float* y, const float* z,
+                  Vector* dest, std::size_t count) {
+    kernels().interleave3(x, y, z, reinterpret_cast<float*>(dest), count);
+  }
+
+  void interleave(const float* x, const float* y, const float* z,
+                  Position* dest, std::size_t count) {
+    kernels().interleave3(x, y, z, reinterpret_cast<float*>(dest), count);
+  }
+
+  void interleave(const float* u, const float* v, const float* w,
+                  TexCoord* dest, std::size_t count) {
+    kernels().interleave3(u, v, w, reinterpret_cast<float*>(dest), count);
+  }
+
+  void interleave(const float* r, const float* g, const float* b, const float* a,
+                  Color* dest, std::size_t count) {
+    kernels().interleave4(r, g, b, a, reinterpret_cast<float*>(dest), count);
+  }
+
+  void deinterleave(const Vector* src,
+                    float* x, float* y, float* z, std::size_t count) {
+    kernels().deinterleave3(reinterpret_cast<const float*>(src), x, y, z, count);
+  }
+
+  void deinterleave(const Position* src,
+                    float* x, float* y, float* z, std::size_t count) {
+    kernels().deinterleave3(reinterpret_cast<const float*>(src), x, y, z, count);
+  }
+
+  void deinterleave(const Color* src,
+                    float* r, float* g, float* b, float* a, std::size_t count) {
+    kernels().deinterleave4(reinterpret_cast<const float*>(src), r, g, b, a, count);
+  }
+
+  namespace impl {
+
+    void remapSamples(const float* src, float* dest, std::size_t count, const RemapTerms& terms) {
+      kernels().remap(src, dest, count, terms);
+    }
+
+    void normalizeSamples(const float* src, float* dest, std::size_t count, const RemapTerms& terms) {
+      kernels().normalize(src, dest, count, terms);
+    }
+
+    void scaleSamples(const float* src, float* dest, std::size_t count, const RemapTerms& terms) {
+      kernels().scale(src, dest, count, terms);
+    }
+
+    void summarizeSamples(const float* src, std::size_t count, SampleSummary& summary) {
+      kernels().summarize(src, count, summary);
+    }
+
+    void sumDeviations(const float* src, std::size_t count, float center,
+                       float& sum, float& sumSquares) {
+      kernels().deviations(src, count, center, sum, sumSquares);
+    }
+
+  }
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include "CPlusPlus_Common.h"
+
+namespace tekt {
+
+  /// Instruction set used by the vectorized kernels. The best one that the
+  /// CPU supports is picked at runtime, so the same plugin binary can run on
+  /// any machine.
+  enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX,
+    NEON,
+  };
+
+  /// The instruction set that the kernels are currently using.
+  SimdLevel simdLevel();
+
+  /// The best instruction set supported by this CPU.
+  SimdLevel detectSimdLevel();
+
+  /// Overrides the instruction set used by the kernels, for example to compare
+  /// results against the scalar versions. A level that isn't supported by the
+  /// CPU falls back to the detected level.
+  void setSimdLevel(SimdLevel level);
+
+  const char* simdLevelName(SimdLevel level);
+
+  /// Packs separate x/y/z component arrays into an array of Vectors.
+  void interleave(const float* x, const float* y, const float* z,
+                  Vector* dest, std::size_t count);
+
+  /// Packs separate x/y/z component arrays into an array of Positions.
+  void interleave(const float* x, const float* y, const float* z,
+                  Position* dest, std::size_t count);
+
+  /// Packs separate u/v/w component arrays into an array of TexCoords.
+  void interleave(const float* u, const float* v, const float* w,
+                  TexCoord* dest, std::size_t count);
+
+  /// Packs separate r/g/b/a component arrays into an array of Colors.
+  void interleave(const float* r, const float* g, const float* b, const float* a,
+                  Color* dest, std::size_t count);
+
+  /// Splits an array of Vectors into separate x/y/z component arrays.
+  void deinterleave(const Vector* src,
+                    float* x, float* y, float* z, std::size_t count);
+
+  /// Splits an array of Positions into separate x/y/z component arrays.
+  void deinterleave(const Position* src,
+                    float* x, float* y, float* z, std::size_t count);
+
+  /// Splits an array of Colors into separate r/g/b/a component arrays.
+  void deinterleave(const Color* src,
+                    float* r, float* g, float* b, float* a, std::size_t count);
+
+  namespace impl {
+
+    /// Terms for remapping values from one range to another, computed once
+    /// for a whole array of values.
+    struct RemapTerms {
+      float inputMin;
+      float inputSpan;
+      float outputSpan;
+      float outputMin;
+      bool clamp;
+      float low;
+      float high;
+    };
+
+    /// dest[i] = (src[i] - inputMin) / inputSpan * outputSpan + outputMin,
+    /// clamped to [low, high] if clamp is set.
+    void remapSamples(const float* src, float* dest, std::size_t count, const RemapTerms& terms);
+
+    /// dest[i] = (src[i] - inputMin) / inputSpan
+    void normalizeSamples(const float* src, float* dest, std::size_t count, const RemapTerms& terms);
+
+    /// dest[i] = src[i] * outputSpan + outputMin, clamped to [low, high] if
+    /// clamp is set.
+    void scaleSamples(const float* src, float* dest, std::size_t count, const RemapTerms& terms);
+
+    struct SampleSummary {
+      float min;
+      float max;
+      float sum;
+    };
+
+    /// Accumulates the min, max and sum of the values into `summary`. NaNs
+    /// are ignored by min and max.
+    void summarizeSamples(const float* src, std::size_t count, SampleSummary& summary);
+
+    /// Accumulates the sums of (src[i] - center) and of its square.
+    void sumDeviations(const float* src, std::size_t count, float center,
+                       float& sum, float& sumSquares);
+
+  }
+
+}
@@ -0,0 +1,82 @@
+#include "TDChannelHistory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace tekt {
+
+  ChannelHistory::ChannelHistory(int32_t capacity)
+    : _capacity(capacity) {
+    assert(capacity > 0);
+  }
+
+  void ChannelHistory::addSource(const float* const* data, float defaultValue) {
+    _sources.push_back({ data, defaultValue });
+    _data.resize(_sources.size() * static_cast<std::size_t>(_capacity));
+    clear();
+  }
+
+  void ChannelHistory::append(const OP_CHOPInput* input) {
+    if (input == nullptr) {
+      return;
+    }
+    append(input->numSamples, input->sampleRate);
+  }
+
+  void ChannelHistory::append(int32_t numSamples, double sampleRate) {
+    _sampleRate = sampleRate;
+    if (numSamples <= 0) {
+      return;
+    }
+    // Only the last `capacity` samples of a long timeslice would survive.
+    auto count = std::min(numSamples, _capacity);
+    auto skipped = numSamples - count;
+    auto firstCount = std::min(count, _capacity - _next);
+    auto secondCount = count - firstCount;
+    for (int32_t channel = 0; channel < channelCount(); channel++) {
+      const auto& source = _sources[channel];
+      auto dest = channelData(channel);
+      auto src = *source.data;
+      if (src == nullptr) {
+        std::fill_n(dest + _next, firstCount, source.defaultValue);
+        std::fill_n(dest, secondCount, source.defaultValue);
+      } else {
+        src += skipped;
+        std::memcpy(dest + _next, src, sizeof(float) * static_cast<std::size_t>(firstCount));
+        std::memcpy(dest, src + firstCount, sizeof(float) * static_cast<std::size_t>(secondCount));
+      }
+    }
+    _next = (_next + count) % _capacity;
+    _size = std::min(_size + count, _capacity);
+  }
+
+  void ChannelHistory::clear() {
+    _size = 0;
+    _next = 0;
+  }
+
+  int32_t ChannelHistory::samplesFor(double seconds) const {
+    if (seconds <= 0.0) {
+      return 0;
+    }
+    auto samples = std::ceil(seconds * _sampleRate);
+    return samples >= _size ? _size : static_cast<int32_t>(samples);
+  }
+
+  HistorySpan ChannelHistory::last(int32_t channel, int32_t count) const {
+    count = std::max(0, std::min(count, _size));
+    auto data = channelData(channel);
+    auto start = _next - count;
+    if (start >= 0) {
+      return { data + start, count, data, 0 };
+    }
+    return { data + start + _capacity, -start, data, _next };
+  }
+
+  void ChannelHistory::copyLast(int32_t channel, int32_t count, float* dest) const {
+    auto span = last(channel, count);
+    std::memcpy(dest, span.first, sizeof(float) * static_cast<std::size_t>(span.firstCount));
+    std::memcpy(dest + span.firstCount, span.second, sizeof(float) * static_cast<std::size_t>(span.secondCount));
+  }
+
+}
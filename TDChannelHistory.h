@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "TDChannels.h"
+
+namespace tekt {
+
+  /// A run of history samples, oldest first. Because the history is a ring
+  /// buffer, the run can be split into two pieces, where `second` continues
+  /// on from the end of `first`.
+  struct HistorySpan {
+    const float* first;
+    int32_t firstCount;
+    const float* second;
+    int32_t secondCount;
+
+    int32_t size() const { return firstCount + secondCount; }
+    float operator[](int32_t i) const {
+      return i < firstCount ? first[i] : second[i - firstCount];
+    }
+  };
+
+  class ChannelHistory;
+
+  /// Typed access to the history of one tracked InputChannel. It refers to
+  /// the ChannelHistory that returned it, which must outlive it.
+  template<typename T>
+  class HistoryField {
+  public:
+    static constexpr std::size_t N = impl::arity<T>::value;
+
+    HistoryField() = default;
+
+    /// The value from `age` samples ago, where 0 is the most recent sample.
+    T get(int32_t age) const;
+
+    /// The channel of the history that holds component `part` of the field.
+    int32_t channel(std::size_t part = 0) const { return _channel + static_cast<int32_t>(part); }
+  private:
+    friend class ChannelHistory;
+
+    HistoryField(const ChannelHistory* history, int32_t channel) : _history(history), _channel(channel) {}
+
+    const ChannelHistory* _history = nullptr;
+    int32_t _channel = -1;
+  };
+
+  /// Keeps the most recent samples of a set of input channels, for OPs that
+  /// need to look back in time, such as lag or delay effects. Each cook's
+  /// samples (a whole timeslice, when the input is timesliced) are appended
+  /// to a preallocated ring buffer for each channel.
+  class ChannelHistory {
+  public:
+    /// Creates a history that holds up to `capacity` samples per channel.
+    explicit ChannelHistory(int32_t capacity);
+
+    // Tracked channels are read through pointers into them, and fields point
+    // back at the history, so it stays where it was created.
+    ChannelHistory(const ChannelHistory&) = delete;
+    ChannelHistory(ChannelHistory&&) = delete;
+    ChannelHistory& operator=(const ChannelHistory&) = delete;
+    ChannelHistory& operator=(ChannelHistory&&) = delete;
+
+    /// Starts recording an input channel. The channel is read directly on
+    /// each append(), so it must outlive the history, and be attached to the
+    /// input before appending. Tracking a channel clears the history.
+    template<typename T>
+    HistoryField<T> track(const InputChannel<T>& channel) {
+      constexpr auto n = impl::arity<T>::value;
+      std::array<float, n> values;
+      OutputChannelTuple<n> tuple;
+      for (std::size_t part = 0; part < n; part++) {
+        tuple[part] = &values[part];
+      }
+      impl::setSample(tuple, 0, channel.defaults());
+      auto first = channelCount();
+      for (std::size_t part = 0; part < n; part++) {
+        addSource(&channel.data()[part], values[part]);
+      }
+      return HistoryField<T>(this, first);
+    }
+
+    /// Appends the input's current samples, read through the tracked channels.
+    /// Missing channels record their default values.
+    void append(const OP_CHOPInput* input);
+
+    /// Appends `numSamples` samples, read through the tracked channels.
+    void append(int32_t numSamples, double sampleRate);
+
+    void clear();
+
+    int32_t capacity() const { return _capacity; }
+    /// Number of samples currently held for each channel.
+    int32_t size() const { return _size; }
+    int32_t channelCount() const { return static_cast<int32_t>(_sources.size()); }
+    double sampleRate() const { return _sampleRate; }
+
+    /// Number of samples that cover the given length of time, at the rate of
+    /// the most recent append(), limited to what the history holds.
+    int32_t samplesFor(double seconds) const;
+
+    /// The sample from `age` samples ago, where 0 is the most recent.
+    float sample(int32_t channel, int32_t age) const {
+      assert(age >= 0 && age < _size);
+      return channelData(channel)[position(age)];
+    }
+
+    /// The last `count` samples of a channel, oldest first, without copying.
+    HistorySpan last(int32_t channel, int32_t count) const;
+
+    /// Copies the last `count` samples of a channel into `dest`, oldest first.
+    void copyLast(int32_t channel, int32_t count, float* dest) const;
+  private:
+    struct Source {
+      const float* const* data;
+      float defaultValue;
+    };
+
+    void addSource(const float* const* data, float defaultValue);
+
+    const float* channelData(int32_t channel) const {
+      return _data.data() + static_cast<std::size_t>(channel) * _capacity;
+    }
+    float* channelData(int32_t channel) {
+      return _data.data() + static_cast<std::size_t>(channel) * _capacity;
+    }
+
+    // Ring position of the sample from `age` samples ago.
+    int32_t position(int32_t age) const {
+      auto pos = _next - 1 - age;
+      return pos < 0 ? pos + _capacity : pos;
+    }
+
+    int32_t _capacity;
+    int32_t _size = 0;
+    // Ring position that the next sample is written to.
+    int32_t _next = 0;
+    double _sampleRate = 0.0;
+    std::vector<Source> _sources;
+    std::vector<float> _data;
+  };
+
+  template<typename T>
+  T HistoryField<T>::get(int32_t age) const {
+    assert(_history != nullptr);
+    std::array<float, N> values;
+    for (std::size_t part = 0; part < N; part++) {
+      values[part] = _history->sample(channel(part), age);
+    }
+    InputChannelTuple<N> tuple;
+    for (std::size_t part = 0; part < N; part++) {
+      tuple[part] = &values[part];
+    }
+    return impl::getSample(tuple, 0, T{});
+  }
+
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "TDChannels.h"
+
+namespace tekt {
+
+  /// Base for the fields of a ChannelSchema. A field derives from this and
+  /// declares its channel names and default value:
+  ///
+  ///     struct Position : ChannelField<Vector> {
+  ///       static constexpr const char* names[] = { "tx", "ty", "tz" };
+  ///       static Vector defaults() { return Vector(0, 0, 0); }
+  ///     };
+  template<typename T>
+  struct ChannelField {
+    using type = T;
+    static constexpr std::size_t size = impl::arity<T>::value;
+  };
+
+  namespace impl {
+
+    template<typename F, std::size_t C>
+    constexpr void appendChannelNames(std::array<const char*, C>& result, std::size_t& next) {
+      static_assert(sizeof(F::names) / sizeof(F::names[0]) == F::size,
+                    "Field needs one channel name for each component");
+      for (std::size_t part = 0; part < F::size; part++) {
+        result[next++] = F::names[part];
+      }
+    }
+
+    template<typename... Fields>
+    constexpr std::array<const char*, (Fields::size + ... + 0)> channelNames() {
+      std::array<const char*, (Fields::size + ... + 0)> result = {};
+      std::size_t next = 0;
+      (appendChannelNames<Fields>(result, next), ...);
+      return result;
+    }
+
+  }
+
+  /// A fixed layout of CHOP channels, made up of a list of fields that are
+  /// known at compile time. Each field gets a fixed range of channel indices,
+  /// in the order that the fields are listed, and the names for
+  /// getChannelName() come from static storage.
+  template<typename... Fields>
+  class ChannelSchema {
+  public:
+    static constexpr std::size_t fieldCount = sizeof...(Fields);
+    static constexpr int32_t channelCount = static_cast<int32_t>((Fields::size + ... + 0));
+
+    /// Index of the first channel of a field.
+    template<typename F>
+    static constexpr int32_t indexOf() {
+      constexpr bool matches[] = { std::is_same_v<F, Fields>... };
+      constexpr std::size_t sizes[] = { Fields::size... };
+      int32_t index = 0;
+      for (std::size_t i = 0; i < fieldCount; i++) {
+        if (matches[i]) {
+          return index;
+        }
+        index += static_cast<int32_t>(sizes[i]);
+      }
+      return -1;
+    }
+
+    static constexpr const char* channelName(int32_t index) { return names[index]; }
+
+    /// Fills in the name for the CHOP's getChannelName().
+    static void getChannelName(int32_t index, OP_String* name) {
+      name->setString(index >= 0 && index < channelCount ? names[index] : "INVALID");
+    }
+
+    /// Fills in the channel count for the CHOP's getOutputInfo().
+    static void getOutputInfo(CHOP_OutputInfo* info) {
+      info->numChannels = channelCount;
+    }
+
+    /// Writes fields into a CHOP's output, whose channels are laid out by
+    /// the schema.
+    class Output {
+    public:
+      void attach(CHOP_Output* output) {
+        assert(output == nullptr || output->numChannels >= channelCount);
+        _channels = output == nullptr ? nullptr : output->channels;
+      }
+      void detach() { _channels = nullptr; }
+
+      template<typename F>
+      void set(int32_t i, const typename F::type& value) {
+        impl::setSample(tuple<F>(), i, value);
+      }
+
+      template<typename F>
+      void set(int32_t start, int32_t count, const typename F::type* values) {
+        impl::setSamples(tuple<F>(), start, count, values);
+      }
+
+      template<typename F>
+      void setDefault(int32_t i) {
+        set<F>(i, F::defaults());
+      }
+
+      /// The output data for one channel of a field.
+      template<typename F>
+      float* data(std::size_t part = 0) const {
+        assert(_channels != nullptr);
+        return _channels[indexOf<F>() + part];
+      }
+    private:
+      template<typename F>
+      OutputChannelTuple<F::size> tuple() const {
+        static_assert(indexOf<F>() >= 0, "Field is not part of the schema");
+        assert(_channels != nullptr);
+        OutputChannelTuple<F::size> result;
+        for (std::size_t part = 0; part < F::size; part++) {
+          result[part] = _channels[indexOf<F>() + part];
+        }
+        return result;
+      }
+
+      float** _channels = nullptr;
+    };
+
+    /// Reads fields from a CHOP input. The input's channels can be in any
+    /// order, so they're resolved by name, but only when the input's layout
+    /// changes. Fields with missing channels read as their defaults.
+    class Input {
+    public:
+      void attach(const OP_CHOPInput* input) {
+        if (input == nullptr) {
+          detach();
+          return;
+        }
+        auto current = input->totalCooks == _totalCooks && _indices.resolvedFrom(input->nameData, input->numChannels);
+        if (!current && !_indices.matches(input->nameData, input->numChannels)) {
+          _indices.resolve(input->nameData, input->numChannels, wantedNames());
+        }
+        _totalCooks = input->totalCooks;
+        auto indices = _indices.data();
+        for (int32_t i = 0; i < channelCount; i++) {
+          _data[i] = indices[i] < 0 ? nullptr : input->getChannelData(indices[i]);
+        }
+      }
+      /// Attaches the same way, and marks the channels that were found as
+      /// used in `chans`, so that ChannelMap::copyUnusedInputs() skips them.
+      void attach(const OP_CHOPInput* input, ChannelMap& chans) {
+        attach(input);
+        if (input != nullptr) {
+          chans.markInputsUsed(_indices.data(), _indices.size());
+        }
+      }
+      void detach() {
+        _data.fill(nullptr);
+      }
+
+      template<typename F>
+      bool isPresent() const {
+        for (std::size_t part = 0; part < F::size; part++) {
+          if (_data[indexOf<F>() + part] == nullptr) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      template<typename F>
+      typename F::type get(int32_t i) const {
+        if (!isPresent<F>()) {
+          return F::defaults();
+        }
+        return impl::getSample(tuple<F>(), i, typename F::type{});
+      }
+
+      template<typename F>
+      void get(int32_t start, int32_t count, typename F::type* dest) const {
+        if (!isPresent<F>()) {
+          std::fill_n(dest, count, F::defaults());
+          return;
+        }
+        impl::getSamples(tuple<F>(), start, count, dest);
+      }
+    private:
+      template<typename F>
+      InputChannelTuple<F::size> tuple() const {
+        static_assert(indexOf<F>() >= 0, "Field is not part of the schema");
+        InputChannelTuple<F::size> result;
+        for (std::size_t part = 0; part < F::size; part++) {
+          result[part] = _data[indexOf<F>() + part];
+        }
+        return result;
+      }
+
+      std::array<const float*, channelCount> _data = {};
+      impl::ChannelBindingIndices _indices;
+      int64_t _totalCooks = -1;
+    };
+  private:
+    static const std::vector<const std::string*>& wantedNames() {
+      static const std::vector<std::string> strings(names.begin(), names.end());
+      static const std::vector<const std::string*> pointers = [] {
+        std::vector<const std::string*> result;
+        for (const auto& name : strings) {
+          result.push_back(&name);
+        }
+        return result;
+      }();
+      return pointers;
+    }
+
+    static constexpr std::array<const char*, channelCount> names = impl::channelNames<Fields...>();
+  };
+
+}
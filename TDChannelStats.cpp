@@ -0,0 +1,108 @@
+#include "TDChannelStats.h"
+#include <algorithm>
+#include <cmath>
+#include "Simd.h"
+
+namespace {
+
+  // Small enough that the second pass over a block reads from L1.
+  constexpr int32_t blockSize = 256;
+
+}
+
+namespace tekt {
+
+  void ChannelStats::add(float value) {
+    if (value < _min) _min = value;
+    if (value > _max) _max = value;
+    _count++;
+    double delta = value - _mean;
+    _mean += delta / static_cast<double>(_count);
+    _m2 += delta * (value - _mean);
+  }
+
+  void ChannelStats::add(const float* values, int32_t count) {
+    for (int32_t start = 0; start < count; start += blockSize) {
+      auto n = std::min(blockSize, count - start);
+      auto src = values + start;
+      impl::SampleSummary summary = { _min, _max, 0.0f };
+      impl::summarizeSamples(src, static_cast<std::size_t>(n), summary);
+      // Deviations from the block's own mean are small, so their float sums
+      // keep their precision however far the samples are from zero.
+      float center = summary.sum / static_cast<float>(n);
+      float sum = 0.0f;
+      float sumSquares = 0.0f;
+      impl::sumDeviations(src, static_cast<std::size_t>(n), center, sum, sumSquares);
+
+      ChannelStats block;
+      block._count = n;
+      block._min = summary.min;
+      block._max = summary.max;
+      block._mean = center + static_cast<double>(sum) / n;
+      block._m2 = std::max(0.0, static_cast<double>(sumSquares) - static_cast<double>(sum) * sum / n);
+      merge(block);
+    }
+  }
+
+  void ChannelStats::merge(const ChannelStats& other) {
+    if (other._count == 0) {
+      return;
+    }
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    if (_count == 0) {
+      _count = other._count;
+      _mean = other._mean;
+      _m2 = other._m2;
+      return;
+    }
+    auto count = _count + other._count;
+    double delta = other._mean - _mean;
+    double weight = static_cast<double>(other._count) / static_cast<double>(count);
+    _mean += delta * weight;
+    _m2 += other._m2 + delta * delta * static_cast<double>(_count) * weight;
+    _count = count;
+  }
+
+  double ChannelStats::standardDeviation() const {
+    return std::sqrt(variance());
+  }
+
+  double ChannelStats::rms() const {
+    return std::sqrt(_mean * _mean + variance());
+  }
+
+  ChannelStats inputChannelStats(const OP_CHOPInput* input, ChannelMap& chans,
+                                 const std::string& name) {
+    ChannelStats stats;
+    auto data = chans.inputData(input, name);
+    if (data != nullptr) {
+      stats.add(data, input->numSamples);
+    }
+    return stats;
+  }
+
+  ChannelStats inputChannelStats(const OP_CHOPInput* input, ChannelMap& chans,
+                                 std::initializer_list<std::string> names) {
+    ChannelStats stats;
+    for (const auto& name : names) {
+      auto data = chans.inputData(input, name);
+      if (data != nullptr) {
+        stats.add(data, input->numSamples);
+      }
+    }
+    return stats;
+  }
+
+  void inputChannelStats(const OP_CHOPInput* input, ChannelMap& chans,
+                         std::vector<ChannelStats>& results) {
+    results.assign(static_cast<std::size_t>(chans.channelCount()), ChannelStats());
+    for (int32_t i = 0; i < chans.channelCount(); i++) {
+      auto data = chans.inputData(input, chans.channelName(i));
+      if (data != nullptr) {
+        results[i].add(data, input->numSamples);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <vector>
+#include "TDChannelHistory.h"
+#include "TDChannels.h"
+
+namespace tekt {
+
+  /// Running min, max, mean and variance of a set of samples, such as for
+  /// auto-ranging a channel. Samples are processed in cache-sized blocks,
+  /// each of which takes a single memory pass with the SIMD kernels, and
+  /// blocks are combined with Welford's (Chan's) update so that the
+  /// variance stays accurate for large offsets and long runs.
+  ///
+  /// Statistics can be kept across cooks by adding each cook's new samples,
+  /// such as a timeslice, or computed for a window of a ChannelHistory by
+  /// adding its HistorySpan.
+  class ChannelStats {
+  public:
+    ChannelStats() = default;
+
+    static ChannelStats of(const float* values, int32_t count) {
+      ChannelStats stats;
+      stats.add(values, count);
+      return stats;
+    }
+
+    void add(float value);
+    void add(const float* values, int32_t count);
+    void add(const HistorySpan& span) {
+      add(span.first, span.firstCount);
+      add(span.second, span.secondCount);
+    }
+
+    /// Combines statistics of another set of samples into these.
+    void merge(const ChannelStats& other);
+
+    void reset() { *this = ChannelStats(); }
+
+    int64_t count() const { return _count; }
+    bool empty() const { return _count == 0; }
+    /// Min and max of the samples, ignoring NaNs, or 0 if there are none.
+    float min() const { return _count > 0 ? _min : 0.0f; }
+    float max() const { return _count > 0 ? _max : 0.0f; }
+    double mean() const { return _mean; }
+    /// Population variance of the samples.
+    double variance() const { return _count > 0 ? _m2 / static_cast<double>(_count) : 0.0; }
+    double standardDeviation() const;
+    /// Root mean square of the samples.
+    double rms() const;
+  private:
+    int64_t _count = 0;
+    float _min = std::numeric_limits<float>::infinity();
+    float _max = -std::numeric_limits<float>::infinity();
+    double _mean = 0.0;
+    // Sum of squared differences from the mean.
+    double _m2 = 0.0;
+  };
+
+  /// Statistics of a named input channel, which are empty if it's missing.
+  ChannelStats inputChannelStats(const OP_CHOPInput* input, ChannelMap& chans,
+                                 const std::string& name);
+
+  /// Combined statistics of several input channels, such as for a shared
+  /// range across the components of a vector.
+  ChannelStats inputChannelStats(const OP_CHOPInput* input, ChannelMap& chans,
+                                 std::initializer_list<std::string> names);
+
+  /// Statistics of each channel in the map, by channel index.
+  void inputChannelStats(const OP_CHOPInput* input, ChannelMap& chans,
+                         std::vector<ChannelStats>& results);
+
+}
@@ -1,4 +1,6 @@
 #include "TDChannels.h"
+#include <cstring>
+#include <string_view>
 
 using namespace tekt;
 
@@ -15,6 +17,7 @@ ChannelMap& ChannelMap::add(const std::string& name)
 {
   _indicesByName[name] = static_cast<int32_t>(_orderedNames.size());
   _orderedNames.push_back(name);
+  _unusedInputs.push_back(0);
   return *this;
 }
 
@@ -31,9 +34,8 @@ ChannelMap& ChannelMap::addFromInput(const OP_CHOPInput* input)
 {
   for (auto i = 0; i < input->numChannels; i++)
   {
-    std::string name = input->getChannelName(i);
-    add(name);
-    _unusedInputNames.insert(name);
+    add(input->getChannelName(i));
+    _unusedInputs.back() = 1;
   }
   return *this;
 }
@@ -42,7 +44,7 @@ void ChannelMap::clear()
 {
   _indicesByName.clear();
   _orderedNames.clear();
-  _unusedInputNames.clear();
+  _unusedInputs.clear();
 }
 
 const float* ChannelMap::inputData(const OP_CHOPInput* input, const std::string& name)
@@ -50,7 +52,7 @@ const float* ChannelMap::inputData(const OP_CHOPInput* input, const std::string&
   if (input == nullptr) return nullptr;
   auto i = channelIndex(name);
   if (i == -1) return nullptr;
-  _unusedInputNames.erase(name);
+  _unusedInputs[i] = 0;
   return input->getChannelData(i);
 }
 
@@ -62,9 +64,204 @@ float* ChannelMap::outputData(CHOP_Output* output, const std::string& name) cons
   return output->channels[i];
 }
 
+void ChannelMap::markInputsUsed(const int32_t* indices, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; i++)
+  {
+    auto index = indices[i];
+    if (index >= 0 && static_cast<std::size_t>(index) < _unusedInputs.size()) _unusedInputs[index] = 0;
+  }
+}
+
+std::vector<int32_t> ChannelMap::unusedInputIndices() const
+{
+  std::vector<int32_t> indices;
+  for (std::size_t i = 0; i < _unusedInputs.size(); i++)
+  {
+    if (_unusedInputs[i]) indices.push_back(static_cast<int32_t>(i));
+  }
+  return indices;
+}
+
+std::unordered_set<std::string> ChannelMap::unusedInputNames() const
+{
+  std::unordered_set<std::string> names;
+  for (std::size_t i = 0; i < _unusedInputs.size(); i++)
+  {
+    if (_unusedInputs[i]) names.insert(_orderedNames[i]);
+  }
+  return names;
+}
+
+void ChannelMap::copyUnusedInputs(const OP_CHOPInput* input, CHOP_Output* output) const
+{
+  if (input == nullptr || output == nullptr) return;
+  auto count = std::min(input->numChannels, output->numChannels);
+  count = std::min(count, channelCount());
+  auto numSamples = std::min(input->numSamples, output->numSamples);
+  if (numSamples <= 0) return;
+  auto bytes = sizeof(float) * static_cast<std::size_t>(numSamples);
+  for (auto i = 0; i < count; i++)
+  {
+    if (!_unusedInputs[i]) continue;
+    std::memcpy(output->channels[i], input->getChannelData(i), bytes);
+  }
+}
+
 int32_t ChannelMap::channelIndex(const std::string& name) const
 {
   auto iter = _indicesByName.find(name);
   if (iter == _indicesByName.end()) return -1;
   return iter->second;
 }
+
+void impl::ChannelBindingIndices::resolve(const char* const* names, int32_t count,
+                                          const std::vector<const std::string*>& wanted)
+{
+  std::unordered_map<std::string_view, int32_t> lookup;
+  lookup.reserve(static_cast<std::size_t>(count));
+  for (auto i = 0; i < count; i++)
+  {
+    lookup.emplace(names[i], i);
+  }
+  _indices.resize(wanted.size());
+  for (std::size_t i = 0; i < wanted.size(); i++)
+  {
+    auto iter = lookup.find(*wanted[i]);
+    _indices[i] = iter == lookup.end() ? -1 : iter->second;
+  }
+  _wanted = wanted;
+  _names = names;
+  _count = count;
+}
+
+bool impl::ChannelBindingIndices::matches(const char* const* names, int32_t count) const
+{
+  if (_count < 0 || count != _count) return false;
+  for (std::size_t i = 0; i < _indices.size(); i++)
+  {
+    auto index = _indices[i];
+    const char* wanted = _wanted[i]->c_str();
+    if (index >= 0)
+    {
+      if (std::strcmp(names[index], wanted) != 0) return false;
+      continue;
+    }
+    // A channel that was missing may have taken the place of another one.
+    for (auto j = 0; j < count; j++)
+    {
+      if (std::strcmp(names[j], wanted) == 0) return false;
+    }
+  }
+  return true;
+}
+
+void impl::ChannelBindingIndices::clear()
+{
+  _indices.clear();
+  _wanted.clear();
+  _names = nullptr;
+  _count = -1;
+}
+
+namespace {
+  template<typename C>
+  std::vector<const std::string*> collectNames(const std::vector<C*>& channels)
+  {
+    std::vector<const std::string*> names;
+    for (auto channel : channels)
+    {
+      for (std::size_t part = 0; part < channel->channelCount(); part++)
+      {
+        names.push_back(&channel->channelName(part));
+      }
+    }
+    return names;
+  }
+}
+
+bool InputChannelBinding::isCurrent(const OP_CHOPInput* input) const
+{
+  if (input == nullptr) return false;
+  if (input->totalCooks == _totalCooks && _indices.resolvedFrom(input->nameData, input->numChannels)) return true;
+  return _indices.matches(input->nameData, input->numChannels);
+}
+
+void InputChannelBinding::attach(const OP_CHOPInput* input)
+{
+  if (input == nullptr)
+  {
+    detach();
+    return;
+  }
+  if (!isCurrent(input))
+  {
+    _indices.resolve(input->nameData, input->numChannels, collectNames(_channels));
+  }
+  _totalCooks = input->totalCooks;
+  auto indices = _indices.data();
+  for (auto channel : _channels)
+  {
+    channel->attachInput(input, indices);
+    indices += channel->channelCount();
+  }
+}
+
+void InputChannelBinding::attach(const OP_CHOPInput* input, ChannelMap& chans)
+{
+  attach(input);
+  if (input == nullptr) return;
+  chans.markInputsUsed(_indices.data(), _indices.size());
+}
+
+void InputChannelBinding::detach()
+{
+  for (auto channel : _channels)
+  {
+    channel->detach();
+  }
+}
+
+void InputChannelBinding::invalidate()
+{
+  _indices.clear();
+  _totalCooks = -1;
+}
+
+bool OutputChannelBinding::isCurrent(const CHOP_Output* output) const
+{
+  if (output == nullptr) return false;
+  return _indices.matches(output->names, output->numChannels);
+}
+
+void OutputChannelBinding::attach(CHOP_Output* output)
+{
+  if (output == nullptr)
+  {
+    detach();
+    return;
+  }
+  if (!isCurrent(output))
+  {
+    _indices.resolve(output->names, output->numChannels, collectNames(_channels));
+  }
+  auto indices = _indices.data();
+  for (auto channel : _channels)
+  {
+    channel->attachOutput(output, indices);
+    indices += channel->channelCount();
+  }
+}
+
+void OutputChannelBinding::detach()
+{
+  for (auto channel : _channels)
+  {
+    channel->detach();
+  }
+}
+
+void OutputChannelBinding::invalidate()
+{
+  _indices.clear();
+}
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <initializer_list>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include "CHOP_CPlusPlusBase.h"
+#include "Simd.h"
 #include "TDValues.h"
 
 namespace tekt {
@@ -99,15 +103,55 @@ namespace tekt {
 
     void getChannelName(int32_t index, OP_String* name) const;
 
-    const std::unordered_set<std::string>& unusedInputNames() const { return _unusedInputNames; }
+    /// Marks the input channels at the given indices as read, for channels
+    /// that are read without going through inputData(). Indices of -1 are
+    /// skipped.
+    void markInputsUsed(const int32_t* indices, std::size_t count);
+
+    /// Indices of the channels that were added from an input and haven't
+    /// been read through inputData() or marked as used.
+    std::vector<int32_t> unusedInputIndices() const;
+
+    std::unordered_set<std::string> unusedInputNames() const;
+
+    /// Copies each input channel that hasn't been read through inputData() to
+    /// the output channel at the same index, so that a CHOP can pass through
+    /// the channels that it doesn't modify.
+    ///
+    /// The map only knows about the reads that go through it, so channels
+    /// read with bindings, channel sets or schemas have to be attached with
+    /// the overloads that take the map, or they're treated as unused and
+    /// overwrite whatever the CHOP wrote to them.
+    void copyUnusedInputs(const OP_CHOPInput* input, CHOP_Output* output) const;
   private:
     std::unordered_map<std::string, int32_t> _indicesByName;
     std::vector<std::string> _orderedNames;
-    std::unordered_set<std::string> _unusedInputNames;
+    // Whether each channel came from an input and is still unread, by index.
+    std::vector<uint8_t> _unusedInputs;
   };
 
   namespace impl {
 
+    template <typename T>
+    std::enable_if_t<!std::is_enum_v<T>, T> fromSample(float value) {
+      return static_cast<T>(value);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_enum_v<T>, T> fromSample(float value) {
+      return static_cast<T>(static_cast<int>(value));
+    }
+
+    template <typename T>
+    std::enable_if_t<!std::is_enum_v<T>, float> toSample(const T& value) {
+      return static_cast<float>(value);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_enum_v<T>, float> toSample(const T& value) {
+      return static_cast<float>(static_cast<int>(value));
+    }
+
     template <typename T>
     std::enable_if_t<!std::is_enum_v<T>, T>
       getSample(const float* data, int32_t i, const T& defaultVal)
@@ -168,7 +212,7 @@ namespace tekt {
     template <typename T>
     void setSample(float* data, int32_t i, T val) {
       if (data != nullptr) {
-        data[i] = static_cast<float>(val);
+        data[i] = toSample(val);
       }
     }
 
@@ -193,6 +237,116 @@ namespace tekt {
       setSample(data[2], i, impl::tupleField<V, 2>(value));
       setSample(data[3], i, impl::tupleField<V, 3>(value));
     }
+
+    // The bulk getSamples() forms expect every data pointer to be non-null, so
+    // that InputChannel can check for missing channels once per range rather
+    // than once per sample.
+
+    template <typename T>
+    void getSamples(const InputChannelTuple<1>& data, int32_t start, int32_t count, T* dest) {
+      const float* src = data[0] + start;
+      for (int32_t i = 0; i < count; i++) {
+        dest[i] = fromSample<T>(src[i]);
+      }
+    }
+
+    template <typename V>
+    void getSamples(const InputChannelTuple<3>& data, int32_t start, int32_t count, V* dest) {
+      const float* x = data[0] + start;
+      const float* y = data[1] + start;
+      const float* z = data[2] + start;
+      for (int32_t i = 0; i < count; i++) {
+        tupleField<V, 0>(dest[i]) = x[i];
+        tupleField<V, 1>(dest[i]) = y[i];
+        tupleField<V, 2>(dest[i]) = z[i];
+      }
+    }
+
+    template <typename V>
+    void getSamples(const InputChannelTuple<4>& data, int32_t start, int32_t count, V* dest) {
+      const float* x = data[0] + start;
+      const float* y = data[1] + start;
+      const float* z = data[2] + start;
+      const float* w = data[3] + start;
+      for (int32_t i = 0; i < count; i++) {
+        tupleField<V, 0>(dest[i]) = x[i];
+        tupleField<V, 1>(dest[i]) = y[i];
+        tupleField<V, 2>(dest[i]) = z[i];
+        tupleField<V, 3>(dest[i]) = w[i];
+      }
+    }
+
+    inline void getSamples(const InputChannelTuple<3>& data, int32_t start, int32_t count, Vector* dest) {
+      interleave(data[0] + start, data[1] + start, data[2] + start,
+                 dest, static_cast<std::size_t>(count));
+    }
+
+    inline void getSamples(const InputChannelTuple<4>& data, int32_t start, int32_t count, Color* dest) {
+      interleave(data[0] + start, data[1] + start, data[2] + start, data[3] + start,
+                 dest, static_cast<std::size_t>(count));
+    }
+
+    template <typename T>
+    void setSamples(const OutputChannelTuple<1>& data, int32_t start, int32_t count, const T* values) {
+      if (data[0] == nullptr) {
+        return;
+      }
+      float* dest = data[0] + start;
+      for (int32_t i = 0; i < count; i++) {
+        dest[i] = toSample(values[i]);
+      }
+    }
+
+    template <typename V, std::size_t I, std::size_t N>
+    void setSamplesField(const OutputChannelTuple<N>& data, int32_t start, int32_t count, const V* values) {
+      if (data[I] == nullptr) {
+        return;
+      }
+      float* dest = data[I] + start;
+      for (int32_t i = 0; i < count; i++) {
+        dest[i] = tupleField<V, I>(values[i]);
+      }
+    }
+
+    template <typename V>
+    void setSamples(const OutputChannelTuple<3>& data, int32_t start, int32_t count, const V* values) {
+      setSamplesField<V, 0>(data, start, count, values);
+      setSamplesField<V, 1>(data, start, count, values);
+      setSamplesField<V, 2>(data, start, count, values);
+    }
+
+    template <typename V>
+    void setSamples(const OutputChannelTuple<4>& data, int32_t start, int32_t count, const V* values) {
+      setSamplesField<V, 0>(data, start, count, values);
+      setSamplesField<V, 1>(data, start, count, values);
+      setSamplesField<V, 2>(data, start, count, values);
+      setSamplesField<V, 3>(data, start, count, values);
+    }
+
+    inline void setSamples(const OutputChannelTuple<3>& data, int32_t start, int32_t count, const Vector* values) {
+      if (data[0] == nullptr || data[1] == nullptr || data[2] == nullptr) {
+        setSamples<Vector>(data, start, count, values);
+        return;
+      }
+      deinterleave(values, data[0] + start, data[1] + start, data[2] + start,
+                   static_cast<std::size_t>(count));
+    }
+
+    inline void setSamples(const OutputChannelTuple<4>& data, int32_t start, int32_t count, const Color* values) {
+      if (data[0] == nullptr || data[1] == nullptr || data[2] == nullptr || data[3] == nullptr) {
+        setSamples<Color>(data, start, count, values);
+        return;
+      }
+      deinterleave(values, data[0] + start, data[1] + start, data[2] + start, data[3] + start,
+                   static_cast<std::size_t>(count));
+    }
+  }
+
+  namespace impl {
+    inline const std::string& noChannelName() {
+      static const std::string name;
+      return name;
+    }
   }
 
   class OutputChannelBase {
@@ -201,7 +355,14 @@ namespace tekt {
     virtual ~OutputChannelBase() = default;
     virtual void detach() = 0;
     virtual void attachOutput(CHOP_Output* outputs, const ChannelMap& chans) = 0;
+    /// Attaches using channel indices that were already resolved, with one
+    /// index (or -1 if missing) for each of the channelCount() parts.
+    /// Subclasses that don't override this and channelCount() are left
+    /// detached by an OutputChannelBinding.
+    virtual void attachOutput(CHOP_Output*, const int32_t*) { detach(); }
     virtual void outputDefault(int32_t i) = 0;
+    virtual std::size_t channelCount() const { return 0; }
+    virtual const std::string& channelName(std::size_t) const { return impl::noChannelName(); }
   };
 
   template<typename T>
@@ -219,13 +380,40 @@ namespace tekt {
     void attachOutput(CHOP_Output* outputs, const ChannelMap& chans) override {
       _output = chans.outputDataTuple(outputs, _names);
     }
+    void attachOutput(CHOP_Output* outputs, const int32_t* indices) override {
+      for (std::size_t part = 0; part < N; part++) {
+        _output[part] = (outputs == nullptr || indices[part] < 0) ? nullptr : outputs->channels[indices[part]];
+      }
+    }
     void output(int32_t i, const T& value) {
       assert(_output[0] != nullptr);
       impl::setSample(_output, i, value);
     }
+    /// Writes `count` values to the samples starting at `start`. Any of the
+    /// channels that aren't present are skipped.
+    void output(int32_t start, int32_t count, const T* values) {
+      impl::setSamples(_output, start, count, values);
+    }
     void outputDefault(int32_t i) override {
       output(i, _defaults);
     }
+    /// Writes the default value to `count` samples starting at `start`.
+    void outputDefaults(int32_t start, int32_t count) {
+      std::array<float, N> values;
+      OutputChannelTuple<N> tuple;
+      for (std::size_t part = 0; part < N; part++) {
+        tuple[part] = &values[part];
+      }
+      impl::setSample(tuple, 0, _defaults);
+      for (std::size_t part = 0; part < N; part++) {
+        if (_output[part] != nullptr) {
+          std::fill_n(_output[part] + start, count, values[part]);
+        }
+      }
+    }
+    const T& defaults() const { return _defaults; }
+    std::size_t channelCount() const override { return N; }
+    const std::string& channelName(std::size_t part) const override { return _names[part]; }
   private:
     const std::array<std::string, N> _names;
     const T _defaults;
@@ -244,6 +432,13 @@ namespace tekt {
     virtual ~InputChannelBase() = default;
     virtual void detach() = 0;
     virtual void attachInput(const OP_CHOPInput* inputs, ChannelMap& chans) = 0;
+    /// Attaches using channel indices that were already resolved, with one
+    /// index (or -1 if missing) for each of the channelCount() parts.
+    /// Subclasses that don't override this and channelCount() are left
+    /// detached by an InputChannelBinding.
+    virtual void attachInput(const OP_CHOPInput*, const int32_t*) { detach(); }
+    virtual std::size_t channelCount() const { return 0; }
+    virtual const std::string& channelName(std::size_t) const { return impl::noChannelName(); }
   };
 
   template<typename T>
@@ -258,6 +453,11 @@ namespace tekt {
     void attachInput(const OP_CHOPInput* inputs, ChannelMap& chans) override {
       _input = chans.inputDataTuple(inputs, _names);
     }
+    void attachInput(const OP_CHOPInput* inputs, const int32_t* indices) override {
+      for (std::size_t part = 0; part < N; part++) {
+        _input[part] = (inputs == nullptr || indices[part] < 0) ? nullptr : inputs->getChannelData(indices[part]);
+      }
+    }
     void detach() override {
       _input.fill(nullptr);
     }
@@ -267,6 +467,21 @@ namespace tekt {
       }
       return impl::getSample(_input, i, _defaults);
     }
+    /// Reads `count` samples starting at `start` into `dest`. If any of the
+    /// channels aren't present, the defaults are used for every sample.
+    void input(int32_t start, int32_t count, T* dest) const {
+      if (!areAllPresent()) {
+        std::fill_n(dest, count, _defaults);
+        return;
+      }
+      impl::getSamples(_input, start, count, dest);
+    }
+    std::size_t channelCount() const override { return N; }
+    const std::string& channelName(std::size_t part) const override { return _names[part]; }
+    const T& defaults() const { return _defaults; }
+    /// The attached input data for each part, which is null for any that are
+    /// missing.
+    const InputChannelTuple<N>& data() const { return _input; }
     bool areAllPresent() const {
       for (std::size_t i = 0; i < N; ++i) {
         if (_input[i] == nullptr) {
@@ -286,4 +501,204 @@ namespace tekt {
   using BoolInChannel = InputChannel<bool>;
   using VectorInChannel = InputChannel<Vector>;
   using ColorInChannel = InputChannel<Color>;
+
+  namespace impl {
+
+    /// Channel indices resolved by name against a host-provided array of
+    /// channel names, along with what is needed to tell whether that array
+    /// still has the same layout.
+    class ChannelBindingIndices {
+    public:
+      void resolve(const char* const* names, int32_t count,
+                   const std::vector<const std::string*>& wanted);
+      /// Whether the names would resolve to the same indices, which checks
+      /// the channels that were found, and scans for the ones that weren't.
+      bool matches(const char* const* names, int32_t count) const;
+      bool resolvedFrom(const char* const* names, int32_t count) const {
+        return names == _names && count == _count;
+      }
+      void clear();
+      bool empty() const { return _count < 0; }
+      const int32_t* data() const { return _indices.data(); }
+      std::size_t size() const { return _indices.size(); }
+    private:
+      std::vector<int32_t> _indices;
+      std::vector<const std::string*> _wanted;
+      const char* const* _names = nullptr;
+      int32_t _count = -1;
+    };
+
+  }
+
+  /// A set of input channels whose names are resolved to channel indices once,
+  /// and then reused on each cook until the layout of the input's channels
+  /// changes. Attaching with a current binding does no name lookups.
+  class InputChannelBinding {
+  public:
+    InputChannelBinding() = default;
+    InputChannelBinding(std::initializer_list<InputChannelBase*> channels) {
+      for (auto channel : channels) {
+        add(*channel);
+      }
+    }
+
+    InputChannelBinding& add(InputChannelBase& channel) {
+      _channels.push_back(&channel);
+      invalidate();
+      return *this;
+    }
+
+    void attach(const OP_CHOPInput* input);
+    /// Attaches the same way, and marks the channels that were found as used
+    /// in `chans`, so that ChannelMap::copyUnusedInputs() skips them.
+    void attach(const OP_CHOPInput* input, ChannelMap& chans);
+    void detach();
+    void invalidate();
+    bool isCurrent(const OP_CHOPInput* input) const;
+  private:
+    std::vector<InputChannelBase*> _channels;
+    impl::ChannelBindingIndices _indices;
+    int64_t _totalCooks = -1;
+  };
+
+  /// A set of output channels whose names are resolved to channel indices once,
+  /// and then reused on each cook until the output's channel names change.
+  class OutputChannelBinding {
+  public:
+    OutputChannelBinding() = default;
+    OutputChannelBinding(std::initializer_list<OutputChannelBase*> channels) {
+      for (auto channel : channels) {
+        add(*channel);
+      }
+    }
+
+    OutputChannelBinding& add(OutputChannelBase& channel) {
+      _channels.push_back(&channel);
+      invalidate();
+      return *this;
+    }
+
+    void attach(CHOP_Output* output);
+    void detach();
+    void invalidate();
+    bool isCurrent(const CHOP_Output* output) const;
+  private:
+    std::vector<OutputChannelBase*> _channels;
+    impl::ChannelBindingIndices _indices;
+  };
+
+  namespace impl {
+    template<typename... Channels>
+    std::vector<const std::string*> channelSetNames(const std::tuple<Channels*...>& channels) {
+      std::vector<const std::string*> names;
+      std::apply([&](auto*... channel) {
+        auto addNames = [&](auto* c) {
+          for (std::size_t part = 0; part < c->channelCount(); part++) {
+            names.push_back(&c->channelName(part));
+          }
+        };
+        (addNames(channel), ...);
+      }, channels);
+      return names;
+    }
+  }
+
+  /// A fixed set of output channels of known types. Unlike a vector of
+  /// OutputChannelBase pointers, attaching, detaching and writing defaults
+  /// for the whole set are single calls that don't go through virtual
+  /// functions.
+  ///
+  ///     OutputChannelSet outputs { ids, positions, colors };
+  template<typename... Channels>
+  class OutputChannelSet {
+  public:
+    explicit OutputChannelSet(Channels&... channels)
+      : _channels(&channels...),
+      _names(impl::channelSetNames(_channels)) {}
+
+    /// Attaches each channel, resolving the output's channel names to indices
+    /// only when they change.
+    void attach(CHOP_Output* output) {
+      if (output == nullptr) {
+        detach();
+        return;
+      }
+      if (!_indices.matches(output->names, output->numChannels)) {
+        _indices.resolve(output->names, output->numChannels, _names);
+      }
+      auto indices = _indices.data();
+      forEach([&](auto& channel) {
+        channel.attachOutput(output, indices);
+        indices += channel.channelCount();
+      });
+    }
+    void attach(CHOP_Output* output, const ChannelMap& chans) {
+      forEach([&](auto& channel) { channel.attachOutput(output, chans); });
+    }
+    void detach() {
+      forEach([](auto& channel) { channel.detach(); });
+    }
+    void outputDefault(int32_t i) {
+      forEach([i](auto& channel) { channel.output(i, channel.defaults()); });
+    }
+    /// Writes every channel's default value to the samples in [begin, end).
+    void fillDefaults(int32_t begin, int32_t end) {
+      forEach([=](auto& channel) { channel.outputDefaults(begin, end - begin); });
+    }
+  private:
+    template<typename F>
+    void forEach(F&& fn) {
+      std::apply([&](auto*... channel) { (fn(*channel), ...); }, _channels);
+    }
+
+    std::tuple<Channels*...> _channels;
+    std::vector<const std::string*> _names;
+    impl::ChannelBindingIndices _indices;
+  };
+
+  /// The input counterpart to OutputChannelSet.
+  template<typename... Channels>
+  class InputChannelSet {
+  public:
+    explicit InputChannelSet(Channels&... channels)
+      : _channels(&channels...),
+      _names(impl::channelSetNames(_channels)) {}
+
+    /// Attaches each channel, resolving the input's channel names to indices
+    /// only when its layout changes.
+    void attach(const OP_CHOPInput* input) {
+      if (input == nullptr) {
+        detach();
+        return;
+      }
+      auto current = input->totalCooks == _totalCooks && _indices.resolvedFrom(input->nameData, input->numChannels);
+      if (!current && !_indices.matches(input->nameData, input->numChannels)) {
+        _indices.resolve(input->nameData, input->numChannels, _names);
+      }
+      _totalCooks = input->totalCooks;
+      auto indices = _indices.data();
+      forEach([&](auto& channel) {
+        channel.attachInput(input, indices);
+        indices += channel.channelCount();
+      });
+    }
+    /// Attaches each channel by looking up its names in `chans`, which marks
+    /// them as used there.
+    void attach(const OP_CHOPInput* input, ChannelMap& chans) {
+      forEach([&](auto& channel) { channel.attachInput(input, chans); });
+    }
+    void detach() {
+      forEach([](auto& channel) { channel.detach(); });
+    }
+  private:
+    template<typename F>
+    void forEach(F&& fn) {
+      std::apply([&](auto*... channel) { (fn(*channel), ...); }, _channels);
+    }
+
+    std::tuple<Channels*...> _channels;
+    std::vector<const std::string*> _names;
+    impl::ChannelBindingIndices _indices;
+    int64_t _totalCooks = -1;
+  };
 }
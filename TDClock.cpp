@@ -1,28 +1,93 @@
 #include "TDClock.h"
+#include <cmath>
 
 namespace tekt {
 
   void Clock::configure(bool running, float rate) {
+    if (running != _running || rate != _rate) {
+      startSegment();
+    }
     _running = running;
     _rate = rate;
   }
 
+  void Clock::setMode(ClockMode mode) {
+    if (mode != _mode) {
+      startSegment();
+      _mode = mode;
+    }
+  }
+
+  void Clock::setFixedStep(double stepSeconds, int maxSteps) {
+    _stepSize = stepSeconds > 0.0 ? stepSeconds : 0.0;
+    _maxSteps = maxSteps;
+    _stepCount = _stepSize > 0.0 ? static_cast<int64_t>(std::floor(_localTime / _stepSize)) : 0;
+    _steps = 0;
+    _alpha = 0.0f;
+  }
+
   void Clock::update(const OP_TimeInfo& timeInfo) {
+    if (!_hasFrame || timeInfo.rootRate != _rootRate) {
+      _lastAbsFrame = timeInfo.absFrame;
+      _rootRate = timeInfo.rootRate;
+      _hasFrame = true;
+      startSegment();
+    }
+    _lastAbsFrame = timeInfo.absFrame;
+
     if (!_running || _rate == 0.0)
     {
-      _timeDelta = 0.0f;
+      _timeDelta = 0.0;
+      _steps = 0;
+      startSegment();
       return;
     }
 
-    auto deltaSec = timeInfo.deltaFrames / timeInfo.rate;
+    if (_mode == ClockMode::AbsoluteFrame) {
+      auto frames = static_cast<double>(timeInfo.absFrame - _segmentFrame);
+      auto nextTime = _segmentTime + frames * (_rate / timeInfo.rootRate);
+      _timeDelta = nextTime - _localTime;
+      _localTime = nextTime;
+    } else {
+      auto deltaSec = timeInfo.deltaFrames / timeInfo.rate;
 
-    _timeDelta = static_cast<float>(deltaSec * _rate);
-    _localTime += _timeDelta;
+      _timeDelta = deltaSec * _rate;
+      _localTime += _timeDelta;
+    }
+    updateSteps();
   }
 
   void Clock::reset() {
     _timeDelta = 0;
     _localTime = 0;
+    _stepCount = 0;
+    _steps = 0;
+    _alpha = 0.0f;
+    startSegment();
+  }
+
+  void Clock::startSegment() {
+    _segmentTime = _localTime;
+    _segmentFrame = _lastAbsFrame;
   }
-}
 
+  void Clock::updateSteps() {
+    if (_stepSize <= 0.0) {
+      return;
+    }
+    // Counting the steps from the total time rather than accumulating
+    // remainders keeps the step boundaries exact over long runs.
+    auto total = static_cast<int64_t>(std::floor(_localTime / _stepSize));
+    auto steps = total - _stepCount;
+    if (steps > _maxSteps) {
+      steps = _maxSteps;
+      _stepCount = total - _maxSteps;
+    } else if (steps < 0) {
+      steps = 0;
+      _stepCount = total;
+    }
+    _stepCount += steps;
+    _steps = static_cast<int>(steps);
+    _alpha = static_cast<float>((_localTime - static_cast<double>(_stepCount) * _stepSize) / _stepSize);
+  }
+}
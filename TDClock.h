@@ -1,23 +1,71 @@
 #pragma once
 
+#include <cstdint>
 #include "CHOP_CPlusPlusBase.h"
 
 namespace tekt {
+
+  enum class ClockMode {
+    /// Adds up the time that elapsed between cooks.
+    Accumulate,
+    /// Derives the time from the host's absolute frame counter, so that it
+    /// doesn't drift no matter how long the clock has been running.
+    AbsoluteFrame,
+  };
+
   class Clock
   {
   public:
+    Clock() = default;
+    explicit Clock(ClockMode mode) : _mode(mode) {}
+
     void configure(bool running, float rate);
+    void setMode(ClockMode mode);
+
+    /// Enables fixed-step updates, where each cook advances the simulation by
+    /// a whole number of steps of the given length. At most maxSteps are run
+    /// per cook, and any time beyond that is dropped. A step of 0 disables
+    /// fixed-step updates.
+    void setFixedStep(double stepSeconds, int maxSteps = 8);
 
     void update(const OP_TimeInfo& timeInfo);
     void reset();
 
     bool running() const { return _running; }
-    float localTime() const { return _localTime; }
-    float timeDelta() const { return _timeDelta; }
+    ClockMode mode() const { return _mode; }
+    float localTime() const { return static_cast<float>(_localTime); }
+    float timeDelta() const { return static_cast<float>(_timeDelta); }
+    double localTimeDouble() const { return _localTime; }
+    double timeDeltaDouble() const { return _timeDelta; }
+
+    /// Number of fixed steps to run for this cook.
+    int steps() const { return _steps; }
+    double stepSize() const { return _stepSize; }
+    /// How far the clock is between the last fixed step and the next one,
+    /// for interpolating between the previous and current simulation state.
+    float alpha() const { return _alpha; }
   private:
-    float _localTime = 0.0f;
-    float _timeDelta = 0.0f;
+    void startSegment();
+    void updateSteps();
+
+    ClockMode _mode = ClockMode::Accumulate;
+    double _localTime = 0.0;
+    double _timeDelta = 0.0;
     bool _running = false;
-    float _rate = 1.0f;
+    double _rate = 1.0;
+
+    // In AbsoluteFrame mode the time is _segmentTime plus the frames since
+    // _segmentFrame. A new segment starts whenever the rate changes.
+    double _segmentTime = 0.0;
+    int64_t _segmentFrame = 0;
+    int64_t _lastAbsFrame = 0;
+    double _rootRate = 0.0;
+    bool _hasFrame = false;
+
+    double _stepSize = 0.0;
+    int _maxSteps = 8;
+    int64_t _stepCount = 0;
+    int _steps = 0;
+    float _alpha = 0.0f;
   };
 }
@@ -0,0 +1,212 @@
+#include "TDGeometry.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include "Simd.h"
+
+namespace tekt {
+
+  GeometryBuilder& GeometryBuilder::withCustomAttribute(const std::string& name, int32_t numComponents,
+                                                        AttribType type) {
+    _customAttributes.push_back({ name, numComponents, type });
+    return *this;
+  }
+
+  void GeometryBuilder::begin(SOP_VBOOutput* output, int32_t numVertices, int32_t numIndices) {
+    assert(output != nullptr);
+    _output = output;
+    if (_normals) {
+      output->enableNormal();
+    }
+    if (_colors) {
+      output->enableColor();
+    }
+    if (_texCoordLayers > 0) {
+      output->enableTexCoord(_texCoordLayers);
+    }
+    for (const auto& attribute : _customAttributes) {
+      output->addCustomAttribute({ attribute.name.c_str(), attribute.numComponents, attribute.type });
+    }
+    output->allocVBO(numVertices, numIndices, _mode);
+
+    _countsChanged = numVertices != _numVertices || numIndices != _numIndices;
+    _numVertices = numVertices;
+    _numIndices = numIndices;
+    _nextCache = 0;
+    _hasBounds = false;
+  }
+
+  void GeometryBuilder::end() {
+    assert(_output != nullptr);
+    if (_hasBounds) {
+      _output->setBoundingBox(BoundingBox(_low, _high));
+    }
+    _output->updateComplete();
+    // Primitives that weren't added this cook don't need their indices.
+    _indexCaches.resize(_nextCache);
+    _output = nullptr;
+  }
+
+  float* GeometryBuilder::customFloats(const char* name) {
+    SOP_CustomAttribData data;
+    if (!_output->getCustomAttribute(&data, name)) {
+      return nullptr;
+    }
+    return const_cast<float*>(data.floatData);
+  }
+
+  int32_t* GeometryBuilder::customInts(const char* name) {
+    SOP_CustomAttribData data;
+    if (!_output->getCustomAttribute(&data, name)) {
+      return nullptr;
+    }
+    return const_cast<int32_t*>(data.intData);
+  }
+
+  void GeometryBuilder::setPositions(int32_t start, int32_t count, const float* x, const float* y, const float* z) {
+    assert(start >= 0 && start + count <= _numVertices);
+    interleave(x, y, z, positions() + start, static_cast<std::size_t>(count));
+    includePositions(x, y, z, count);
+  }
+
+  void GeometryBuilder::setPositions(int32_t start, int32_t count, const Position* values) {
+    assert(start >= 0 && start + count <= _numVertices);
+    std::memcpy(positions() + start, values, sizeof(Position) * static_cast<std::size_t>(count));
+    for (int32_t i = 0; i < count; i++) {
+      includeBounds(values[i], values[i]);
+    }
+  }
+
+  void GeometryBuilder::setPositions(int32_t start, int32_t count, const InputChannel<Vector>& channel) {
+    if (!channel.areAllPresent()) {
+      const auto& value = channel.defaults();
+      std::fill_n(positions() + start, count, Position(value.x, value.y, value.z));
+      if (count > 0) {
+        includeBounds(positions()[start], positions()[start]);
+      }
+      return;
+    }
+    const auto& data = channel.data();
+    setPositions(start, count, data[0] + start, data[1] + start, data[2] + start);
+  }
+
+  void GeometryBuilder::setNormals(int32_t start, int32_t count, const float* x, const float* y, const float* z) {
+    assert(start >= 0 && start + count <= _numVertices);
+    interleave(x, y, z, normals() + start, static_cast<std::size_t>(count));
+  }
+
+  void GeometryBuilder::setNormals(int32_t start, int32_t count, const InputChannel<Vector>& channel) {
+    if (!channel.areAllPresent()) {
+      fillNormals(start, count, channel.defaults());
+      return;
+    }
+    const auto& data = channel.data();
+    setNormals(start, count, data[0] + start, data[1] + start, data[2] + start);
+  }
+
+  void GeometryBuilder::fillNormals(int32_t start, int32_t count, const Vector& value) {
+    assert(start >= 0 && start + count <= _numVertices);
+    std::fill_n(normals() + start, count, value);
+  }
+
+  void GeometryBuilder::setColors(int32_t start, int32_t count,
+                                  const float* r, const float* g, const float* b, const float* a) {
+    assert(start >= 0 && start + count <= _numVertices);
+    interleave(r, g, b, a, colors() + start, static_cast<std::size_t>(count));
+  }
+
+  void GeometryBuilder::setColors(int32_t start, int32_t count, const InputChannel<Color>& channel) {
+    if (!channel.areAllPresent()) {
+      fillColors(start, count, channel.defaults());
+      return;
+    }
+    const auto& data = channel.data();
+    setColors(start, count, data[0] + start, data[1] + start, data[2] + start, data[3] + start);
+  }
+
+  void GeometryBuilder::fillColors(int32_t start, int32_t count, const Color& value) {
+    assert(start >= 0 && start + count <= _numVertices);
+    std::fill_n(colors() + start, count, value);
+  }
+
+  void GeometryBuilder::includeBounds(const Position& low, const Position& high) {
+    if (!_hasBounds) {
+      _low = low;
+      _high = high;
+      _hasBounds = true;
+      return;
+    }
+    _low = Position(std::min(_low.x, low.x), std::min(_low.y, low.y), std::min(_low.z, low.z));
+    _high = Position(std::max(_high.x, high.x), std::max(_high.y, high.y), std::max(_high.z, high.z));
+  }
+
+  void GeometryBuilder::includePositions(const float* x, const float* y, const float* z, int32_t count) {
+    if (count <= 0) {
+      return;
+    }
+    const float inf = std::numeric_limits<float>::infinity();
+    impl::SampleSummary sx = { inf, -inf, 0.0f };
+    impl::SampleSummary sy = sx;
+    impl::SampleSummary sz = sx;
+    impl::summarizeSamples(x, static_cast<std::size_t>(count), sx);
+    impl::summarizeSamples(y, static_cast<std::size_t>(count), sy);
+    impl::summarizeSamples(z, static_cast<std::size_t>(count), sz);
+    includeBounds(Position(sx.min, sy.min, sz.min), Position(sx.max, sy.max, sz.max));
+  }
+
+  void GeometryBuilder::addParticleSystem(int32_t numParticles, int32_t start) {
+    assert(_output != nullptr);
+    assert(start >= 0 && start + numParticles <= _numVertices);
+    auto indices = _output->addParticleSystem(numParticles);
+    std::iota(indices, indices + numParticles, start);
+  }
+
+  int32_t PointWriter::addPoints(SOP_Output* output, const InputChannel<Vector>& positions, int32_t count) {
+    if (positions.areAllPresent()) {
+      const auto& data = positions.data();
+      return addPoints(output, data[0], data[1], data[2], count);
+    }
+    auto first = output->getNumPoints();
+    const auto& value = positions.defaults();
+    _positions.assign(static_cast<std::size_t>(count), Position(value.x, value.y, value.z));
+    output->addPoints(_positions.data(), count);
+    return first;
+  }
+
+  int32_t PointWriter::addPoints(SOP_Output* output, const float* x, const float* y, const float* z, int32_t count) {
+    auto first = output->getNumPoints();
+    if (_positions.size() < static_cast<std::size_t>(count)) {
+      _positions.resize(static_cast<std::size_t>(count));
+    }
+    interleave(x, y, z, _positions.data(), static_cast<std::size_t>(count));
+    output->addPoints(_positions.data(), count);
+    return first;
+  }
+
+  void PointWriter::setNormals(SOP_Output* output, const InputChannel<Vector>& normals, int32_t firstPoint, int32_t count) {
+    output->setNormals(stage(_vectors, normals, count), count, firstPoint);
+  }
+
+  void PointWriter::setColors(SOP_Output* output, const InputChannel<Color>& colors, int32_t firstPoint, int32_t count) {
+    output->setColors(stage(_colors, colors, count), count, firstPoint);
+  }
+
+  void PointWriter::setTexCoords(SOP_Output* output, const InputChannel<Vector>& uvw, int32_t firstPoint, int32_t count) {
+    if (_texCoords.size() < static_cast<std::size_t>(count)) {
+      _texCoords.resize(static_cast<std::size_t>(count));
+    }
+    if (uvw.areAllPresent()) {
+      const auto& data = uvw.data();
+      interleave(data[0], data[1], data[2], _texCoords.data(), static_cast<std::size_t>(count));
+    } else {
+      const auto& value = uvw.defaults();
+      std::fill_n(_texCoords.data(), count, TexCoord(value.x, value.y, value.z));
+    }
+    output->setTexCoords(_texCoords.data(), count, 1, firstPoint);
+  }
+
+  void GeometryBuilder::copyIndices(const std::vector<int32_t>& indices, int32_t* dest) const {
+    std::memcpy(dest, indices.data(), sizeof(int32_t) * indices.size());
+  }
+
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "SOP_CPlusPlusBase.h"
+#include "TDChannels.h"
+
+namespace tekt {
+
+  /// Fills a SOP's VBO output, in executeVBO(), from arrays of point data
+  /// such as CHOP-style channels with one array per component. The
+  /// attributes are declared once, and each cook allocates the VBO from
+  /// known counts and copies whole arrays into it with the SIMD interleave
+  /// kernels, rather than setting one point at a time.
+  ///
+  /// Primitive indices usually only depend on the counts, so they're kept
+  /// between cooks and only regenerated when the counts change.
+  class GeometryBuilder {
+  public:
+    GeometryBuilder& withNormals() { _normals = true; return *this; }
+    GeometryBuilder& withColors() { _colors = true; return *this; }
+    GeometryBuilder& withTexCoords(int32_t layers = 1) { _texCoordLayers = layers; return *this; }
+    GeometryBuilder& withCustomAttribute(const std::string& name, int32_t numComponents,
+                                         AttribType type = AttribType::Float);
+    GeometryBuilder& withBufferMode(VBOBufferMode mode) { _mode = mode; return *this; }
+
+    /// Enables the declared attributes and allocates the VBO. This must be
+    /// called before anything else in each executeVBO().
+    void begin(SOP_VBOOutput* output, int32_t numVertices, int32_t numIndices);
+
+    /// Sets the bounding box, if any positions were written from arrays or
+    /// a box was given, and completes the VBO.
+    void end();
+
+    /// Whether the counts given to begin() differ from the previous cook.
+    bool countsChanged() const { return _countsChanged; }
+    int32_t numVertices() const { return _numVertices; }
+
+    Position* positions() { return _output->getPos(); }
+    Vector* normals() { assert(_normals); return _output->getNormals(); }
+    Color* colors() { assert(_colors); return _output->getColors(); }
+    TexCoord* texCoords() { assert(_texCoordLayers > 0); return _output->getTexCoords(); }
+    /// The VBO data for a declared custom attribute, with numComponents
+    /// values per vertex, or nullptr if there's no such attribute.
+    float* customFloats(const char* name);
+    int32_t* customInts(const char* name);
+
+    void setPositions(int32_t start, int32_t count, const float* x, const float* y, const float* z);
+    void setPositions(int32_t start, int32_t count, const Position* values);
+    /// Writes samples [start, start + count) of an input channel, or its
+    /// default if any of its channels are missing.
+    void setPositions(int32_t start, int32_t count, const InputChannel<Vector>& channel);
+
+    void setNormals(int32_t start, int32_t count, const float* x, const float* y, const float* z);
+    void setNormals(int32_t start, int32_t count, const InputChannel<Vector>& channel);
+    void fillNormals(int32_t start, int32_t count, const Vector& value);
+
+    void setColors(int32_t start, int32_t count, const float* r, const float* g, const float* b, const float* a);
+    void setColors(int32_t start, int32_t count, const InputChannel<Color>& channel);
+    void fillColors(int32_t start, int32_t count, const Color& value);
+
+    /// Includes a box in the bounding box set by end().
+    void includeBounds(const Position& low, const Position& high);
+
+    /// Adds triangles, whose 3 * numTriangles indices are written by
+    /// `fill(int32_t* indices)` only when the counts have changed, and are
+    /// otherwise copied from the previous cook. Call invalidateIndices() if
+    /// the indices can change while the counts stay the same.
+    template<typename F>
+    void addTriangles(int32_t numTriangles, F&& fill) {
+      auto& cached = indexCache(3 * numTriangles, fill);
+      copyIndices(cached, _output->addTriangles(numTriangles));
+    }
+
+    /// Adds a line strip, whose indices are written by `fill` in the same
+    /// way as addTriangles().
+    template<typename F>
+    void addLines(int32_t numIndices, F&& fill) {
+      auto& cached = indexCache(numIndices, fill);
+      copyIndices(cached, _output->addLines(numIndices));
+    }
+
+    /// Adds a particle system with one particle for each of the vertices
+    /// [start, start + numParticles).
+    void addParticleSystem(int32_t numParticles, int32_t start = 0);
+
+    /// Makes the next cook regenerate every primitive's indices.
+    void invalidateIndices() { _indexCaches.clear(); }
+  private:
+    struct CustomAttribute {
+      std::string name;
+      int32_t numComponents;
+      AttribType type;
+    };
+
+    template<typename F>
+    const std::vector<int32_t>& indexCache(int32_t count, F& fill) {
+      assert(_output != nullptr);
+      if (_nextCache == _indexCaches.size()) {
+        _indexCaches.emplace_back();
+      }
+      auto& cached = _indexCaches[_nextCache++];
+      if (_countsChanged || cached.size() != static_cast<std::size_t>(count)) {
+        cached.resize(static_cast<std::size_t>(count));
+        fill(cached.data());
+      }
+      return cached;
+    }
+
+    void copyIndices(const std::vector<int32_t>& indices, int32_t* dest) const;
+    void includePositions(const float* x, const float* y, const float* z, int32_t count);
+
+    SOP_VBOOutput* _output = nullptr;
+    bool _normals = false;
+    bool _colors = false;
+    int32_t _texCoordLayers = 0;
+    VBOBufferMode _mode = VBOBufferMode::Dynamic;
+    std::vector<CustomAttribute> _customAttributes;
+
+    int32_t _numVertices = -1;
+    int32_t _numIndices = -1;
+    bool _countsChanged = true;
+    std::vector<std::vector<int32_t>> _indexCaches;
+    std::size_t _nextCache = 0;
+
+    bool _hasBounds = false;
+    Position _low;
+    Position _high;
+  };
+
+  /// Writes points to a SOP_Output, in execute(), from per-component arrays
+  /// such as bound input channels. Each attribute is packed into a staging
+  /// array, which is kept between cooks, and then passed to the output in a
+  /// single bulk call, rather than one call per point. Channels that are
+  /// missing write their defaults.
+  class PointWriter {
+  public:
+    /// Adds a point for each of the first `count` samples of the channel,
+    /// and returns the index of the first new point.
+    int32_t addPoints(SOP_Output* output, const InputChannel<Vector>& positions, int32_t count);
+    int32_t addPoints(SOP_Output* output, const float* x, const float* y, const float* z, int32_t count);
+
+    /// Sets the attribute of points [firstPoint, firstPoint + count) from
+    /// the first `count` samples of the channel.
+    void setNormals(SOP_Output* output, const InputChannel<Vector>& normals, int32_t firstPoint, int32_t count);
+    void setColors(SOP_Output* output, const InputChannel<Color>& colors, int32_t firstPoint, int32_t count);
+    /// Sets a single layer of texture coordinates, from u/v/w channels.
+    void setTexCoords(SOP_Output* output, const InputChannel<Vector>& uvw, int32_t firstPoint, int32_t count);
+
+    /// Sets a custom attribute of the first `count` points, with one
+    /// component for each channel. Float, int, Vector and Color channels
+    /// are supported.
+    template<typename T>
+    void setCustomAttribute(SOP_Output* output, const char* name, const InputChannel<T>& channel, int32_t count) {
+      constexpr auto n = static_cast<int32_t>(impl::arity<T>::value);
+      if constexpr (std::is_same_v<T, float>) {
+        SOP_CustomAttribData data(name, n, AttribType::Float);
+        // A single float channel already has the layout the SOP wants.
+        if (channel.areAllPresent()) {
+          data.floatData = channel.data()[0];
+        } else {
+          data.floatData = stage(_floats, channel, count);
+        }
+        output->setCustomAttribute(&data, count);
+      } else if constexpr (std::is_same_v<T, int>) {
+        SOP_CustomAttribData data(name, n, AttribType::Int);
+        data.intData = stage(_ints, channel, count);
+        output->setCustomAttribute(&data, count);
+      } else if constexpr (std::is_same_v<T, Vector>) {
+        SOP_CustomAttribData data(name, n, AttribType::Float);
+        data.floatData = reinterpret_cast<const float*>(stage(_vectors, channel, count));
+        output->setCustomAttribute(&data, count);
+      } else {
+        static_assert(std::is_same_v<T, Color>, "Unsupported custom attribute type");
+        SOP_CustomAttribData data(name, n, AttribType::Float);
+        data.floatData = reinterpret_cast<const float*>(stage(_colors, channel, count));
+        output->setCustomAttribute(&data, count);
+      }
+    }
+  private:
+    template<typename T>
+    const T* stage(std::vector<T>& buffer, const InputChannel<T>& channel, int32_t count) {
+      if (buffer.size() < static_cast<std::size_t>(count)) {
+        buffer.resize(static_cast<std::size_t>(count));
+      }
+      channel.input(0, count, buffer.data());
+      return buffer.data();
+    }
+
+    std::vector<Position> _positions;
+    std::vector<Vector> _vectors;
+    std::vector<Color> _colors;
+    std::vector<TexCoord> _texCoords;
+    std::vector<float> _floats;
+    std::vector<int> _ints;
+  };
+
+}
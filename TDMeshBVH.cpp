@@ -0,0 +1,481 @@
+#include "TDMeshBVH.h"
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+#include "Parallel.h"
+
+namespace {
+
+  constexpr int numBins = 16;
+  // Nodes with this many triangles or fewer become leaves when splitting
+  // them isn't cheaper by the SAH.
+  constexpr int32_t maxLeafSize = 4;
+  // Limits the traversal stack, since each level adds at most one entry.
+  constexpr int32_t maxDepth = 60;
+  constexpr int stackSize = maxDepth + 4;
+  // Samples read from the input channels at a time by the batched queries.
+  constexpr int32_t queryBatch = 64;
+
+  struct Vec3 {
+    float x;
+    float y;
+    float z;
+
+    Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+    Vec3(const Position& p) : x(p.x), y(p.y), z(p.z) {}
+    Vec3(const Vector& v) : x(v.x), y(v.y), z(v.z) {}
+
+    float operator[](int axis) const { return axis == 0 ? x : axis == 1 ? y : z; }
+    Vec3 operator+(const Vec3& o) const { return { x + o.x, y + o.y, z + o.z }; }
+    Vec3 operator-(const Vec3& o) const { return { x - o.x, y - o.y, z - o.z }; }
+    Vec3 operator*(float s) const { return { x * s, y * s, z * s }; }
+    Position position() const { return Position(x, y, z); }
+  };
+
+  float dot(const Vec3& a, const Vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+  }
+
+  Vec3 cross(const Vec3& a, const Vec3& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+  }
+
+  struct Box {
+    float low[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float high[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    void include(const Vec3& p) {
+      for (int axis = 0; axis < 3; axis++) {
+        low[axis] = std::min(low[axis], p[axis]);
+        high[axis] = std::max(high[axis], p[axis]);
+      }
+    }
+
+    void include(const Box& other) {
+      for (int axis = 0; axis < 3; axis++) {
+        low[axis] = std::min(low[axis], other.low[axis]);
+        high[axis] = std::max(high[axis], other.high[axis]);
+      }
+    }
+
+    float area() const {
+      if (low[0] > high[0]) {
+        return 0.0f;
+      }
+      auto dx = high[0] - low[0];
+      auto dy = high[1] - low[1];
+      auto dz = high[2] - low[2];
+      return 2.0f * (dx * dy + dy * dz + dz * dx);
+    }
+  };
+
+  struct Bin {
+    Box box;
+    int32_t count = 0;
+  };
+
+  // Distance along the ray to where it enters the box, or FLT_MAX if it
+  // misses the box or enters it beyond `limit`.
+  float boxEntry(const float* low, const float* high, const Vec3& origin, const Vec3& invDir, float limit) {
+    float near = 0.0f;
+    float far = limit;
+    for (int axis = 0; axis < 3; axis++) {
+      auto t1 = (low[axis] - origin[axis]) * invDir[axis];
+      auto t2 = (high[axis] - origin[axis]) * invDir[axis];
+      near = std::max(near, std::min(t1, t2));
+      far = std::min(far, std::max(t1, t2));
+    }
+    return near <= far ? near : FLT_MAX;
+  }
+
+  float boxDistanceSquared(const float* low, const float* high, const Vec3& p) {
+    float d = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+      auto excess = std::max(std::max(low[axis] - p[axis], p[axis] - high[axis]), 0.0f);
+      d += excess * excess;
+    }
+    return d;
+  }
+
+  // Moller-Trumbore, hitting either side of the triangle.
+  bool intersectTriangle(const Vec3& a, const Vec3& b, const Vec3& c,
+                         const Vec3& origin, const Vec3& dir, float limit,
+                         float& t, float& u, float& v) {
+    auto e1 = b - a;
+    auto e2 = c - a;
+    auto p = cross(dir, e2);
+    auto det = dot(e1, p);
+    if (det == 0.0f) {
+      return false;
+    }
+    auto invDet = 1.0f / det;
+    auto s = origin - a;
+    u = dot(s, p) * invDet;
+    if (!(u >= 0.0f && u <= 1.0f)) {
+      return false;
+    }
+    auto q = cross(s, e1);
+    v = dot(dir, q) * invDet;
+    if (!(v >= 0.0f && u + v <= 1.0f)) {
+      return false;
+    }
+    t = dot(e2, q) * invDet;
+    return t > 0.0f && t < limit;
+  }
+
+  // From Ericson, Real-Time Collision Detection, 5.1.5.
+  Vec3 closestOnTriangle(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c) {
+    auto ab = b - a;
+    auto ac = c - a;
+    auto ap = p - a;
+    auto d1 = dot(ab, ap);
+    auto d2 = dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+      return a;
+    }
+    auto bp = p - b;
+    auto d3 = dot(ab, bp);
+    auto d4 = dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+      return b;
+    }
+    auto vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+      return a + ab * (d1 / (d1 - d3));
+    }
+    auto cp = p - c;
+    auto d5 = dot(ab, cp);
+    auto d6 = dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+      return c;
+    }
+    auto vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+      return a + ac * (d2 / (d2 - d6));
+    }
+    auto va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+      return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+    auto denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+  }
+
+}
+
+namespace tekt {
+
+  bool MeshBVH::update(const OP_SOPInput* input) {
+    if (input == nullptr) {
+      auto hadInput = _totalCooks >= 0;
+      clear();
+      return hadInput;
+    }
+    if (input->opId == _opId && input->totalCooks == _totalCooks) {
+      return false;
+    }
+    _reader.attach(input);
+    auto positions = _reader.positions();
+    auto numPoints = positions.size();
+    _unsorted.clear();
+    for (const auto& prim : _reader.primitives()) {
+      if (prim.numVertices < 3 || prim.pointIndices == nullptr) {
+        continue;
+      }
+      auto primitive = static_cast<int32_t>(&prim - _reader.primitives().data());
+      const auto* indices = prim.pointIndices;
+      // Polygons are split into fans around their first point.
+      for (int32_t j = 1; j + 1 < prim.numVertices; j++) {
+        auto a = indices[0];
+        auto b = indices[j];
+        auto c = indices[j + 1];
+        if (a < 0 || b < 0 || c < 0 || a >= numPoints || b >= numPoints || c >= numPoints) {
+          continue;
+        }
+        _unsorted.push_back({ positions[a], positions[b], positions[c], primitive });
+      }
+    }
+    _reader.detach();
+    buildTree();
+    _opId = input->opId;
+    _totalCooks = input->totalCooks;
+    return true;
+  }
+
+  void MeshBVH::build(const Position* points, const int32_t* indices, int32_t numTriangles) {
+    _unsorted.clear();
+    for (int32_t t = 0; t < numTriangles; t++) {
+      const auto* tri = indices + 3 * t;
+      _unsorted.push_back({ points[tri[0]], points[tri[1]], points[tri[2]], t });
+    }
+    buildTree();
+    // The next update() rebuilds from its input.
+    _opId = 0;
+    _totalCooks = -1;
+  }
+
+  void MeshBVH::clear() {
+    _triangles.clear();
+    _nodes.clear();
+    _opId = 0;
+    _totalCooks = -1;
+  }
+
+  void MeshBVH::buildTree() {
+    auto count = static_cast<int32_t>(_unsorted.size());
+    _nodes.clear();
+    _triangles.clear();
+    if (count == 0) {
+      return;
+    }
+    _refs.resize(_unsorted.size());
+    std::iota(_refs.begin(), _refs.end(), 0);
+    _centroids.resize(_unsorted.size());
+    for (std::size_t i = 0; i < _unsorted.size(); i++) {
+      const auto& tri = _unsorted[i];
+      _centroids[i] = ((Vec3(tri.a) + Vec3(tri.b) + Vec3(tri.c)) * (1.0f / 3.0f)).position();
+    }
+
+    struct Task {
+      int32_t node;
+      int32_t start;
+      int32_t count;
+      int32_t depth;
+    };
+    std::vector<Task> tasks;
+    // A tree with n leaves has 2n - 1 nodes, so this never reallocates.
+    _nodes.reserve(2 * _unsorted.size());
+    _nodes.emplace_back();
+    tasks.push_back({ 0, 0, count, 0 });
+    while (!tasks.empty()) {
+      auto task = tasks.back();
+      tasks.pop_back();
+      auto refs = _refs.data() + task.start;
+
+      Box bounds;
+      Box centroidBounds;
+      for (int32_t i = 0; i < task.count; i++) {
+        const auto& tri = _unsorted[refs[i]];
+        bounds.include(Vec3(tri.a));
+        bounds.include(Vec3(tri.b));
+        bounds.include(Vec3(tri.c));
+        centroidBounds.include(Vec3(_centroids[refs[i]]));
+      }
+      auto& node = _nodes[task.node];
+      std::copy_n(bounds.low, 3, node.low);
+      std::copy_n(bounds.high, 3, node.high);
+      node.start = task.start;
+      node.count = task.count;
+      if (task.count <= 1 || task.depth >= maxDepth) {
+        continue;
+      }
+
+      int axis = 0;
+      for (int a = 1; a < 3; a++) {
+        if (centroidBounds.high[a] - centroidBounds.low[a] > centroidBounds.high[axis] - centroidBounds.low[axis]) {
+          axis = a;
+        }
+      }
+      auto lowest = centroidBounds.low[axis];
+      auto extent = centroidBounds.high[axis] - lowest;
+      auto scale = extent > 0.0f ? numBins / extent : 0.0f;
+      auto binOf = [&](int32_t ref) {
+        auto f = (Vec3(_centroids[ref])[axis] - lowest) * scale;
+        return f > 0.0f ? std::min(static_cast<int>(f), numBins - 1) : 0;
+      };
+
+      Bin bins[numBins];
+      for (int32_t i = 0; i < task.count; i++) {
+        auto& bin = bins[binOf(refs[i])];
+        const auto& tri = _unsorted[refs[i]];
+        bin.box.include(Vec3(tri.a));
+        bin.box.include(Vec3(tri.b));
+        bin.box.include(Vec3(tri.c));
+        bin.count++;
+      }
+      // rightCost[i] is the SAH term for everything in bins i and up.
+      float rightCost[numBins];
+      int32_t rightCount[numBins];
+      Box right;
+      int32_t n = 0;
+      for (int i = numBins - 1; i > 0; i--) {
+        right.include(bins[i].box);
+        n += bins[i].count;
+        rightCost[i] = right.area() * static_cast<float>(n);
+        rightCount[i] = n;
+      }
+      auto bestCost = FLT_MAX;
+      int bestSplit = -1;
+      Box left;
+      n = 0;
+      for (int i = 1; i < numBins; i++) {
+        left.include(bins[i - 1].box);
+        n += bins[i - 1].count;
+        if (n == 0 || rightCount[i] == 0) {
+          continue;
+        }
+        auto cost = left.area() * static_cast<float>(n) + rightCost[i];
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestSplit = i;
+        }
+      }
+
+      int32_t mid;
+      if (bestSplit < 0) {
+        // All the centroids are in one bin, so the split can't separate
+        // them spatially.
+        if (task.count <= maxLeafSize) {
+          continue;
+        }
+        mid = task.start + task.count / 2;
+      } else {
+        // Splitting costs a traversal step, against testing every triangle.
+        auto leafCost = bounds.area() * static_cast<float>(task.count - 1);
+        if (task.count <= maxLeafSize && !(bestCost < leafCost)) {
+          continue;
+        }
+        mid = static_cast<int32_t>(std::partition(refs, refs + task.count, [&](int32_t ref) {
+          return binOf(ref) < bestSplit;
+        }) - _refs.data());
+      }
+
+      auto children = static_cast<int32_t>(_nodes.size());
+      _nodes.emplace_back();
+      _nodes.emplace_back();
+      _nodes[task.node].start = children;
+      _nodes[task.node].count = 0;
+      tasks.push_back({ children + 1, mid, task.start + task.count - mid, task.depth + 1 });
+      tasks.push_back({ children, task.start, mid - task.start, task.depth + 1 });
+    }
+
+    _triangles.resize(_unsorted.size());
+    for (std::size_t i = 0; i < _refs.size(); i++) {
+      _triangles[i] = _unsorted[_refs[i]];
+    }
+  }
+
+  bool MeshBVH::intersect(const Position& origin, const Vector& direction, float maxDistance, RayHit& hit) const {
+    hit = { maxDistance, -1, 0.0f, 0.0f };
+    if (_nodes.empty()) {
+      return false;
+    }
+    Vec3 o(origin);
+    Vec3 dir(direction);
+    Vec3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+    auto best = maxDistance;
+
+    int32_t stack[stackSize];
+    int top = 0;
+    if (boxEntry(_nodes[0].low, _nodes[0].high, o, invDir, best) != FLT_MAX) {
+      stack[top++] = 0;
+    }
+    while (top > 0) {
+      const auto& node = _nodes[stack[--top]];
+      if (node.count > 0) {
+        for (auto i = node.start; i < node.start + node.count; i++) {
+          const auto& tri = _triangles[i];
+          float t, u, v;
+          if (intersectTriangle(Vec3(tri.a), Vec3(tri.b), Vec3(tri.c), o, dir, best, t, u, v)) {
+            best = t;
+            hit = { t, tri.primitive, u, v };
+          }
+        }
+        continue;
+      }
+      // Visiting the nearer child first shrinks `best` sooner.
+      auto nearChild = node.start;
+      auto farChild = node.start + 1;
+      auto nearT = boxEntry(_nodes[nearChild].low, _nodes[nearChild].high, o, invDir, best);
+      auto farT = boxEntry(_nodes[farChild].low, _nodes[farChild].high, o, invDir, best);
+      if (farT < nearT) {
+        std::swap(nearChild, farChild);
+        std::swap(nearT, farT);
+      }
+      if (farT != FLT_MAX) {
+        stack[top++] = farChild;
+      }
+      if (nearT != FLT_MAX) {
+        stack[top++] = nearChild;
+      }
+    }
+    return hit.isHit();
+  }
+
+  bool MeshBVH::closestPoint(const Position& point, float maxDistance, SurfacePoint& result) const {
+    auto best = maxDistance * maxDistance;
+    result = { point, best, -1 };
+    if (_nodes.empty()) {
+      return false;
+    }
+    Vec3 p(point);
+
+    int32_t stack[stackSize];
+    int top = 0;
+    if (boxDistanceSquared(_nodes[0].low, _nodes[0].high, p) < best) {
+      stack[top++] = 0;
+    }
+    while (top > 0) {
+      const auto& node = _nodes[stack[--top]];
+      if (node.count > 0) {
+        for (auto i = node.start; i < node.start + node.count; i++) {
+          const auto& tri = _triangles[i];
+          auto q = closestOnTriangle(p, Vec3(tri.a), Vec3(tri.b), Vec3(tri.c));
+          auto offset = q - p;
+          auto d = dot(offset, offset);
+          if (d < best) {
+            best = d;
+            result = { q.position(), d, tri.primitive };
+          }
+        }
+        continue;
+      }
+      auto nearChild = node.start;
+      auto farChild = node.start + 1;
+      auto nearD = boxDistanceSquared(_nodes[nearChild].low, _nodes[nearChild].high, p);
+      auto farD = boxDistanceSquared(_nodes[farChild].low, _nodes[farChild].high, p);
+      if (farD < nearD) {
+        std::swap(nearChild, farChild);
+        std::swap(nearD, farD);
+      }
+      if (farD < best) {
+        stack[top++] = farChild;
+      }
+      if (nearD < best) {
+        stack[top++] = nearChild;
+      }
+    }
+    return result.isFound();
+  }
+
+  void MeshBVH::intersect(const InputChannel<Vector>& origins, const InputChannel<Vector>& directions,
+                          int32_t count, RayHit* hits, float maxDistance) const {
+    parallelForRange(0, count, [&](int32_t begin, int32_t end) {
+      Vector o[queryBatch];
+      Vector d[queryBatch];
+      for (auto start = begin; start < end; start += queryBatch) {
+        auto n = std::min(queryBatch, end - start);
+        origins.input(start, n, o);
+        directions.input(start, n, d);
+        for (int32_t j = 0; j < n; j++) {
+          intersect(Position(o[j].x, o[j].y, o[j].z), d[j], maxDistance, hits[start + j]);
+        }
+      }
+    });
+  }
+
+  void MeshBVH::closestPoints(const InputChannel<Vector>& points, int32_t count, SurfacePoint* results,
+                              float maxDistance) const {
+    parallelForRange(0, count, [&](int32_t begin, int32_t end) {
+      Vector p[queryBatch];
+      for (auto start = begin; start < end; start += queryBatch) {
+        auto n = std::min(queryBatch, end - start);
+        points.input(start, n, p);
+        for (int32_t j = 0; j < n; j++) {
+          closestPoint(Position(p[j].x, p[j].y, p[j].z), maxDistance, results[start + j]);
+        }
+      }
+    });
+  }
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "SOP_CPlusPlusBase.h"
+#include "TDChannels.h"
+#include "TDSOPInput.h"
+
+namespace tekt {
+
+  /// Where a ray hit a mesh. `u` and `v` are the barycentric coordinates of
+  /// the hit within the triangle, weighting its second and third points.
+  struct RayHit {
+    float distance;
+    /// The primitive that was hit, or -1 for a miss.
+    int32_t primitive;
+    float u;
+    float v;
+
+    bool isHit() const { return primitive >= 0; }
+  };
+
+  /// The point on a mesh nearest to a query point.
+  struct SurfacePoint {
+    Position position;
+    float distanceSquared;
+    /// The primitive the point is on, or -1 if nothing was in range.
+    int32_t primitive;
+
+    bool isFound() const { return primitive >= 0; }
+  };
+
+  /// A bounding volume hierarchy over the triangles of a mesh, such as a SOP
+  /// input, for casting rays and finding the nearest point on the surface
+  /// without testing every triangle.
+  ///
+  /// The tree is built with binned SAH splits into a flat array of nodes,
+  /// where the two children of a node are adjacent. The triangles' points
+  /// are copied in leaf order, so the tree stays valid when the input's data
+  /// moves, and it's only rebuilt when the input cooks.
+  ///
+  /// Queries don't modify the tree, so they can be made from parallelFor()
+  /// bodies.
+  class MeshBVH {
+  public:
+    /// Rebuilds the tree from the input's polygons, which are split into
+    /// triangle fans, if the input has cooked since the last update.
+    /// Returns true if it was rebuilt.
+    bool update(const OP_SOPInput* input);
+
+    /// Builds the tree from triangles given as three point indices each.
+    /// The triangle's index is used as its primitive.
+    void build(const Position* points, const int32_t* indices, int32_t numTriangles);
+
+    void clear();
+
+    bool empty() const { return _triangles.empty(); }
+    int32_t numTriangles() const { return static_cast<int32_t>(_triangles.size()); }
+    int32_t numNodes() const { return static_cast<int32_t>(_nodes.size()); }
+
+    /// Finds the nearest triangle, from either side, that the ray hits
+    /// within `maxDistance`. The direction doesn't need to be normalized,
+    /// in which case distances are in multiples of its length.
+    bool intersect(const Position& origin, const Vector& direction, float maxDistance, RayHit& hit) const;
+
+    /// Finds the nearest point on the mesh within `maxDistance`.
+    bool closestPoint(const Position& point, float maxDistance, SurfacePoint& result) const;
+
+    /// Casts a ray for each of the first `count` samples of the channels,
+    /// on the shared thread pool.
+    void intersect(const InputChannel<Vector>& origins, const InputChannel<Vector>& directions, int32_t count,
+                   RayHit* hits, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+    /// Finds the nearest point on the mesh for each of the first `count`
+    /// samples of the channel, on the shared thread pool.
+    void closestPoints(const InputChannel<Vector>& points, int32_t count, SurfacePoint* results,
+                       float maxDistance = std::numeric_limits<float>::infinity()) const;
+  private:
+    struct Triangle {
+      Position a;
+      Position b;
+      Position c;
+      int32_t primitive;
+    };
+
+    // A leaf if count > 0, holding triangles [start, start + count).
+    // Otherwise its children are nodes start and start + 1.
+    struct Node {
+      float low[3];
+      float high[3];
+      int32_t start;
+      int32_t count;
+    };
+
+    void buildTree();
+
+    std::vector<Triangle> _triangles;
+    std::vector<Node> _nodes;
+
+    SOPInputReader _reader;
+    uint32_t _opId = 0;
+    int64_t _totalCooks = -1;
+
+    // Scratch space for building.
+    std::vector<Triangle> _unsorted;
+    std::vector<int32_t> _refs;
+    std::vector<Position> _centroids;
+  };
+
+}
@@ -14,8 +14,8 @@ namespace {
     int getInt(const std::string& name) const {
       return static_cast<int>(inputs.getParInt(name.c_str(), 0));
     }
-    std::string getString(const std::string& name) const {
-      return std::string(inputs.getParString(name.c_str()));
+    const char* getString(const std::string& name) const {
+      return inputs.getParString(name.c_str());
     }
     Vector getVector(const std::string& name) const {
       double x, y, z;
@@ -40,13 +40,148 @@ namespace {
 
 namespace tekt {
 
+  void ParTable::clear() {
+    _entries.clear();
+    _strings.clear();
+    _names.clear();
+    _status = OP_ParAppendResult::Success;
+  }
+
+  OP_ParAppendResult ParTable::check(const char* name, int32_t size) {
+    auto result = OP_ParAppendResult::Success;
+    if (name == nullptr || *name == '\0' || _names.count(name) != 0) {
+      result = OP_ParAppendResult::InvalidName;
+    } else if (size < 1 || size > 4) {
+      result = OP_ParAppendResult::InvalidSize;
+    }
+    if (_status == OP_ParAppendResult::Success) {
+      _status = result;
+    }
+    return result;
+  }
+
+  const char* ParTable::copy(const char* str) {
+    if (str == nullptr) {
+      return nullptr;
+    }
+    // Pages repeat for every parameter on them, so reuse the last copy.
+    if (!_strings.empty() && _strings.back() == str) {
+      return _strings.back().c_str();
+    }
+    _strings.emplace_back(str);
+    return _strings.back().c_str();
+  }
+
+  OP_ParAppendResult ParTable::record(Kind kind, const OP_NumericParameter& np, int32_t size) {
+    auto result = check(np.name, size);
+    if (result != OP_ParAppendResult::Success) {
+      return result;
+    }
+    Entry entry{ kind, size, np, {}, {}, {} };
+    entry.numeric.name = copy(np.name);
+    _names.insert(entry.numeric.name);
+    entry.numeric.label = copy(np.label);
+    entry.numeric.page = copy(np.page);
+    _entries.push_back(std::move(entry));
+    return OP_ParAppendResult::Success;
+  }
+
+  OP_ParAppendResult ParTable::record(Kind kind, const OP_StringParameter& sp,
+                                      int32_t nitems, const char** names, const char** labels) {
+    auto result = check(sp.name, 1);
+    if (result != OP_ParAppendResult::Success) {
+      return result;
+    }
+    Entry entry{ kind, 0, {}, sp, {}, {} };
+    entry.string.name = copy(sp.name);
+    _names.insert(entry.string.name);
+    entry.string.label = copy(sp.label);
+    entry.string.page = copy(sp.page);
+    entry.string.defaultValue = copy(sp.defaultValue);
+    for (int32_t i = 0; i < nitems; i++) {
+      entry.menuNames.push_back(copy(names[i]));
+      entry.menuLabels.push_back(copy(labels[i]));
+    }
+    _entries.push_back(std::move(entry));
+    return OP_ParAppendResult::Success;
+  }
+
+  OP_ParAppendResult ParTable::replay(OP_ParameterManager* manager) const {
+    auto first = OP_ParAppendResult::Success;
+    for (const auto& entry : _entries) {
+      const auto& np = entry.numeric;
+      const auto& sp = entry.string;
+      auto itemCount = static_cast<int32_t>(entry.menuNames.size());
+      auto names = const_cast<const char**>(entry.menuNames.data());
+      auto labels = const_cast<const char**>(entry.menuLabels.data());
+      OP_ParAppendResult res = OP_ParAppendResult::Success;
+      switch (entry.kind) {
+        case Kind::Float: res = manager->appendFloat(np, entry.size); break;
+        case Kind::Int: res = manager->appendInt(np, entry.size); break;
+        case Kind::XY: res = manager->appendXY(np); break;
+        case Kind::XYZ: res = manager->appendXYZ(np); break;
+        case Kind::UV: res = manager->appendUV(np); break;
+        case Kind::UVW: res = manager->appendUVW(np); break;
+        case Kind::RGB: res = manager->appendRGB(np); break;
+        case Kind::RGBA: res = manager->appendRGBA(np); break;
+        case Kind::Toggle: res = manager->appendToggle(np); break;
+        case Kind::Pulse: res = manager->appendPulse(np); break;
+        case Kind::String: res = manager->appendString(sp); break;
+        case Kind::File: res = manager->appendFile(sp); break;
+        case Kind::Folder: res = manager->appendFolder(sp); break;
+        case Kind::DAT: res = manager->appendDAT(sp); break;
+        case Kind::CHOP: res = manager->appendCHOP(sp); break;
+        case Kind::TOP: res = manager->appendTOP(sp); break;
+        case Kind::Object: res = manager->appendObject(sp); break;
+        case Kind::Menu: res = manager->appendMenu(sp, itemCount, names, labels); break;
+        case Kind::StringMenu: res = manager->appendStringMenu(sp, itemCount, names, labels); break;
+        case Kind::SOP: res = manager->appendSOP(sp); break;
+        case Kind::Python: res = manager->appendPython(sp); break;
+      }
+      if (first == OP_ParAppendResult::Success) {
+        first = res;
+      }
+    }
+    return first;
+  }
+
+  OP_ParAppendResult ParTable::appendFloat(const OP_NumericParameter& np, int32_t size) { return record(Kind::Float, np, size); }
+  OP_ParAppendResult ParTable::appendInt(const OP_NumericParameter& np, int32_t size) { return record(Kind::Int, np, size); }
+  OP_ParAppendResult ParTable::appendXY(const OP_NumericParameter& np) { return record(Kind::XY, np, 2); }
+  OP_ParAppendResult ParTable::appendXYZ(const OP_NumericParameter& np) { return record(Kind::XYZ, np, 3); }
+  OP_ParAppendResult ParTable::appendUV(const OP_NumericParameter& np) { return record(Kind::UV, np, 2); }
+  OP_ParAppendResult ParTable::appendUVW(const OP_NumericParameter& np) { return record(Kind::UVW, np, 3); }
+  OP_ParAppendResult ParTable::appendRGB(const OP_NumericParameter& np) { return record(Kind::RGB, np, 3); }
+  OP_ParAppendResult ParTable::appendRGBA(const OP_NumericParameter& np) { return record(Kind::RGBA, np, 4); }
+  OP_ParAppendResult ParTable::appendToggle(const OP_NumericParameter& np) { return record(Kind::Toggle, np, 1); }
+  OP_ParAppendResult ParTable::appendPulse(const OP_NumericParameter& np) { return record(Kind::Pulse, np, 1); }
+  OP_ParAppendResult ParTable::appendString(const OP_StringParameter& sp) { return record(Kind::String, sp); }
+  OP_ParAppendResult ParTable::appendFile(const OP_StringParameter& sp) { return record(Kind::File, sp); }
+  OP_ParAppendResult ParTable::appendFolder(const OP_StringParameter& sp) { return record(Kind::Folder, sp); }
+  OP_ParAppendResult ParTable::appendDAT(const OP_StringParameter& sp) { return record(Kind::DAT, sp); }
+  OP_ParAppendResult ParTable::appendCHOP(const OP_StringParameter& sp) { return record(Kind::CHOP, sp); }
+  OP_ParAppendResult ParTable::appendTOP(const OP_StringParameter& sp) { return record(Kind::TOP, sp); }
+  OP_ParAppendResult ParTable::appendObject(const OP_StringParameter& sp) { return record(Kind::Object, sp); }
+  OP_ParAppendResult ParTable::appendSOP(const OP_StringParameter& sp) { return record(Kind::SOP, sp); }
+  OP_ParAppendResult ParTable::appendPython(const OP_StringParameter& sp) { return record(Kind::Python, sp); }
+
+  OP_ParAppendResult ParTable::appendMenu(const OP_StringParameter& sp, int32_t nitems,
+                                          const char** names, const char** labels) {
+    return record(Kind::Menu, sp, nitems, names, labels);
+  }
+
+  OP_ParAppendResult ParTable::appendStringMenu(const OP_StringParameter& sp, int32_t nitems,
+                                                const char** names, const char** labels) {
+    return record(Kind::StringMenu, sp, nitems, names, labels);
+  }
+
   void BoolParameter::create(ParBuilder& pars) const {
     pars.addToggle({ name, label }, defaultValue);
   }
 
   void BoolParameter::load(const OP_Inputs& inputs) {
     ParAccessor pars{ inputs };
-    value = pars.getBool(name);
+    update(value, pars.getBool(name));
   }
 
   void StringParameter::create(ParBuilder& pars) const {
@@ -59,7 +194,21 @@ namespace tekt {
 
   void StringParameter::load(const OP_Inputs& inputs) {
     ParAccessor pars{ inputs };
-    value = pars.getString(name);
+    update(value, pars.getString(name));
+  }
+
+  void MenuParameter::create(ParBuilder& pars) const {
+    assert(!menuOptions.options.empty());
+    pars.addMenu({ name, label }, menuOptions.options[defaultIndex].name, menuOptions);
+  }
+
+  void MenuParameter::load(const OP_Inputs& inputs) {
+    ParAccessor pars{ inputs };
+    auto index = pars.getInt(name);
+    if (index < 0 || index >= static_cast<int>(menuOptions.options.size())) {
+      index = defaultIndex;
+    }
+    update(value, index);
   }
 
   template <>
@@ -75,13 +224,13 @@ namespace tekt {
   template <>
   void NumericParameter<float>::load(const OP_Inputs& inputs) {
     ParAccessor pars{ inputs };
-    value = pars.getFloat(name);
+    update(value, pars.getFloat(name));
   }
 
   template <>
   void NumericParameter<int>::load(const OP_Inputs& inputs) {
     ParAccessor pars{ inputs };
-    value = pars.getInt(name);
+    update(value, pars.getInt(name));
   }
 
   template <>
@@ -93,7 +242,10 @@ namespace tekt {
   template <>
   void ValueRangeParameter<float>::load(const OP_Inputs& inputs) {
     ParAccessor pars{ inputs };
-    pars.getFloatPair(name, &values.low, &values.high);
+    ValueRangeMapper<float> next;
+    pars.getFloatPair(name, &next.low, &next.high);
+    update(values, next);
+    values.prepare();
   }
 
   void VectorParameter::create(ParBuilder& pars) const {
@@ -102,7 +254,7 @@ namespace tekt {
 
   void VectorParameter::load(const OP_Inputs& inputs) {
     ParAccessor pars{ inputs };
-    values = pars.getVector(name);
+    update(values, pars.getVector(name));
   }
 
   void RGBAColorParameter::create(ParBuilder& pars) const {
@@ -111,7 +263,7 @@ namespace tekt {
 
   void RGBAColorParameter::load(const OP_Inputs& inputs) {
     ParAccessor pars{ inputs };
-    values = pars.getRGBAColor(name);
+    update(values, pars.getRGBAColor(name));
   }
 
   void PulseParameter::create(ParBuilder& pars) const {
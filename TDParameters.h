@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <deque>
 #include <initializer_list>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include "CHOP_CPlusPlusBase.h"
@@ -44,25 +48,39 @@ namespace tekt {
   /// A set of menu options for a menu or string menu parameter.
   class MenuOpts {
   public:
-    MenuOpts(std::initializer_list<MenuOpt> mOpts) : options(mOpts) {}
+    MenuOpts(std::initializer_list<MenuOpt> mOpts) : options(mOpts) {
+      buildLists();
+    }
+    MenuOpts(const MenuOpts& other) : options(other.options) {
+      buildLists();
+    }
 
     const std::vector<MenuOpt> options;
 
-  private:
-    std::vector<const char*> getNameList() const {
-      std::vector<const char*> names;
-      for (const auto& option : options) {
-        names.push_back(option.name.c_str());
+    /// The index of the option with the given name, or -1 if there is none.
+    int indexOf(const std::string& name) const {
+      for (std::size_t i = 0; i < options.size(); i++) {
+        if (options[i].name == name) {
+          return static_cast<int>(i);
+        }
       }
-      return names;
+      return -1;
     }
-    std::vector<const char*> getLabelList() const {
-      std::vector<const char*> labels;
-      for (const auto& option: options) {
-        labels.push_back(option.label.c_str());
+
+  private:
+    // The lists point into `options`, so they're built once here rather than
+    // every time the parameters are set up.
+    void buildLists() {
+      for (const auto& option : options) {
+        _names.push_back(option.name.c_str());
+        _labels.push_back(option.label.c_str());
       }
-      return labels;
     }
+    const std::vector<const char*>& getNameList() const { return _names; }
+    const std::vector<const char*>& getLabelList() const { return _labels; }
+
+    std::vector<const char*> _names;
+    std::vector<const char*> _labels;
 
     friend class ParBuilder;
   };
@@ -178,13 +196,11 @@ namespace tekt {
       opts.applyTo(p);
       setPage(p);
       p.defaultValue = defaultValue.c_str();
-      auto names = menuOpts.getNameList();
-      auto labels = menuOpts.getLabelList();
       check(opts, _manager->appendStringMenu(
         p,
         static_cast<int32_t>(menuOpts.options.size()),
-        names.data(),
-        labels.data()));
+        const_cast<const char**>(menuOpts.getNameList().data()),
+        const_cast<const char**>(menuOpts.getLabelList().data())));
     }
 
     void addMenu(const ParOpts& opts, const std::string& defaultValue, const MenuOpts& menuOpts) const {
@@ -192,13 +208,11 @@ namespace tekt {
       opts.applyTo(p);
       setPage(p);
       p.defaultValue = defaultValue.c_str();
-      auto names = menuOpts.getNameList();
-      auto labels = menuOpts.getLabelList();
       check(opts, _manager->appendMenu(
         p,
         static_cast<int32_t>(menuOpts.options.size()),
-        names.data(),
-        labels.data()));
+        const_cast<const char**>(menuOpts.getNameList().data()),
+        const_cast<const char**>(menuOpts.getLabelList().data())));
     }
 
     void addPulse(const ParOpts& opts) const {
@@ -283,6 +297,86 @@ namespace tekt {
     const std::string _page;
   };
 
+  /// A recorded list of parameter definitions, which can be replayed into
+  /// the host's parameter manager without rebuilding each parameter's
+  /// settings. Appending parameters to the table records them, copying any
+  /// strings, so a table can be filled once (such as by Settings::create())
+  /// and shared by every instance of an OP whose parameters don't vary.
+  class ParTable final : public OP_ParameterManager {
+  public:
+    ParTable() = default;
+    ParTable(const ParTable&) = delete;
+    ParTable& operator=(const ParTable&) = delete;
+
+    bool empty() const { return _entries.empty(); }
+    std::size_t size() const { return _entries.size(); }
+    void clear();
+
+    /// The first failure from recording, if any. Parameters that failed
+    /// (with a missing or repeated name, or a size out of range) aren't
+    /// recorded, the same as the host would leave them out.
+    OP_ParAppendResult status() const { return _status; }
+
+    /// Appends each of the recorded parameters to a parameter manager, in
+    /// the order that they were recorded. If the manager rejects any of
+    /// them, the rest are still appended, and the first failure is returned.
+    OP_ParAppendResult replay(OP_ParameterManager* manager) const;
+
+    OP_ParAppendResult appendFloat(const OP_NumericParameter& np, int32_t size = 1) override;
+    OP_ParAppendResult appendInt(const OP_NumericParameter& np, int32_t size = 1) override;
+    OP_ParAppendResult appendXY(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendXYZ(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendUV(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendUVW(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendRGB(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendRGBA(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendToggle(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendPulse(const OP_NumericParameter& np) override;
+    OP_ParAppendResult appendString(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendFile(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendFolder(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendDAT(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendCHOP(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendTOP(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendObject(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendMenu(const OP_StringParameter& sp, int32_t nitems,
+                                  const char** names, const char** labels) override;
+    OP_ParAppendResult appendStringMenu(const OP_StringParameter& sp, int32_t nitems,
+                                        const char** names, const char** labels) override;
+    OP_ParAppendResult appendSOP(const OP_StringParameter& sp) override;
+    OP_ParAppendResult appendPython(const OP_StringParameter& sp) override;
+  private:
+    enum class Kind : uint8_t {
+      Float, Int, XY, XYZ, UV, UVW, RGB, RGBA, Toggle, Pulse,
+      String, File, Folder, DAT, CHOP, TOP, Object, Menu, StringMenu, SOP, Python,
+    };
+
+    struct Entry {
+      Kind kind;
+      int32_t size;
+      OP_NumericParameter numeric;
+      OP_StringParameter string;
+      std::vector<const char*> menuNames;
+      std::vector<const char*> menuLabels;
+    };
+
+    OP_ParAppendResult record(Kind kind, const OP_NumericParameter& np, int32_t size);
+    OP_ParAppendResult record(Kind kind, const OP_StringParameter& sp,
+                              int32_t nitems = 0, const char** names = nullptr, const char** labels = nullptr);
+    OP_ParAppendResult check(const char* name, int32_t size);
+    const char* copy(const char* str);
+
+    std::vector<Entry> _entries;
+    // Names of the recorded parameters, pointing into _strings.
+    std::unordered_set<std::string_view> _names;
+    OP_ParAppendResult _status = OP_ParAppendResult::Success;
+    // Copies of the recorded strings. A deque never moves its elements, so
+    // the entries can point directly into it.
+    std::deque<std::string> _strings;
+  };
+
+  class PulseParameter;
+
   /// Base class for objects that represent a parameter (or tuplet of parameters).
   /// 
   /// This acts as a combination of the definition of the parameter and its settings
@@ -298,6 +392,39 @@ namespace tekt {
     virtual void load(const OP_Inputs& inputs) = 0;
 
     virtual bool isPulse() const { return false; }
+    virtual PulseParameter* asPulse() { return nullptr; }
+
+    /// Whether the most recent call to load() changed the value. The first
+    /// load always counts as a change. Subclasses that don't load their
+    /// value through update() count as changed on every load.
+    bool hasChanged() const { return changed; }
+  protected:
+    template<typename T>
+    void update(T& current, const T& next) {
+      changed = !loaded || !impl::valuesEqual(current, next);
+      loaded = true;
+      if (changed) {
+        current = next;
+      }
+    }
+
+    // Compares before assigning, so that an unchanged string doesn't
+    // allocate, and a changed one reuses the existing buffer when it fits.
+    void update(std::string& current, const char* next) {
+      if (next == nullptr) {
+        next = "";
+      }
+      changed = !loaded || current != next;
+      loaded = true;
+      if (changed) {
+        current.assign(next);
+      }
+    }
+
+    // Only update() clears this, so a subclass that doesn't use it never
+    // causes a change to be missed.
+    bool changed = true;
+    bool loaded = false;
   };
 
   class BoolParameter final : public Parameter {
@@ -329,6 +456,27 @@ namespace tekt {
     std::string value;
   };
 
+  /// A menu parameter, which loads the index of the selected option rather
+  /// than its name, so code that uses it can switch on an int.
+  class MenuParameter final : public Parameter {
+  public:
+    MenuParameter(std::string n, std::string l, const std::string& defVal, MenuOpts menuOpts)
+      : Parameter(std::move(n), std::move(l)),
+      menuOptions(std::move(menuOpts)),
+      defaultIndex(std::max(menuOptions.indexOf(defVal), 0)), value(defaultIndex) {}
+
+    void create(ParBuilder& pars) const override;
+    void load(const OP_Inputs& inputs) override;
+    int get() const { return value; }
+    template<typename E>
+    E getAs() const { return static_cast<E>(value); }
+    const std::string& getName() const { return menuOptions.options[value].name; }
+  private:
+    const MenuOpts menuOptions;
+    const int defaultIndex;
+    int value;
+  };
+
   template <typename T>
   class NumericParameter final : public Parameter {
   public:
@@ -358,10 +506,10 @@ namespace tekt {
     void create(ParBuilder& pars) const override;
     void load(const OP_Inputs& inputs) override;
 
-    const tekt::ValueRange<T>& get() { return values; }
+    const tekt::ValueRangeMapper<T>& get() { return values; }
   private:
     const NumericOptsArray<T, 2> numericOpts;
-    tekt::ValueRange<T> values;
+    tekt::ValueRangeMapper<T> values;
   };
 
   class VectorParameter final : public Parameter {
@@ -404,13 +552,19 @@ namespace tekt {
 
   /// A Pulse parameter, which tracks the state of whether it has been
   /// triggered, and resets the state after the state is checked.
+  ///
+  /// A pulse that is still pending when load() is called counts as a
+  /// change, so that hasChanged() on its group reflects it.
   class PulseParameter final : public Parameter {
   public:
     PulseParameter(std::string n, std::string l)
       : Parameter(std::move(n), std::move(l)) {}
 
     void create(ParBuilder& pars) const override;
-    void load(const OP_Inputs& inputs) override {}
+    void load(const OP_Inputs&) override {
+      changed = state;
+      loaded = true;
+    }
 
     void set() { state = true; }
 
@@ -424,6 +578,7 @@ namespace tekt {
     }
 
     bool isPulse() const override { return true; }
+    PulseParameter* asPulse() override { return this; }
   private:
     bool state = false;
   };
@@ -442,6 +597,8 @@ namespace tekt {
     void load(const OP_Inputs& inputs);
 
     ValueRange<Vector> get() const { return { low.get(), high.get() };}
+
+    bool hasChanged() const { return low.hasChanged() || high.hasChanged(); }
   };
 
 }
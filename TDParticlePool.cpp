@@ -0,0 +1,123 @@
+#include "TDParticlePool.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+  constexpr std::size_t floatsPerCacheLine = 16;
+
+}
+
+namespace tekt {
+
+  ParticlePool::ParticlePool(int32_t capacity)
+    : _capacity(capacity),
+    _stride((static_cast<std::size_t>(capacity) + floatsPerCacheLine - 1) / floatsPerCacheLine * floatsPerCacheLine),
+    _alive(static_cast<std::size_t>(capacity), 0) {
+    assert(capacity >= 0);
+    resetFreeList(0);
+  }
+
+  int32_t ParticlePool::spawn() {
+    if (_free.empty()) {
+      return -1;
+    }
+    auto i = _free.back();
+    _free.pop_back();
+    _alive[i] = 1;
+    return i;
+  }
+
+  void ParticlePool::kill(int32_t i) {
+    assert(i >= 0 && i < _capacity);
+    if (!_alive[i]) {
+      return;
+    }
+    resetSlot(i);
+    _alive[i] = 0;
+    _free.push_back(i);
+  }
+
+  void ParticlePool::clear() {
+    for (int32_t channel = 0; channel < channelCount(); channel++) {
+      std::fill_n(channelData(channel), _capacity, _defaults[channel]);
+    }
+    std::fill(_alive.begin(), _alive.end(), 0);
+    resetFreeList(0);
+  }
+
+  void ParticlePool::compact() {
+    int32_t next = 0;
+    for (int32_t i = 0; i < _capacity; i++) {
+      if (!_alive[i]) {
+        continue;
+      }
+      if (i != next) {
+        for (int32_t channel = 0; channel < channelCount(); channel++) {
+          auto data = channelData(channel);
+          data[next] = data[i];
+        }
+        _alive[next] = 1;
+      }
+      next++;
+    }
+    for (int32_t channel = 0; channel < channelCount(); channel++) {
+      std::fill(channelData(channel) + next, channelData(channel) + _capacity, _defaults[channel]);
+    }
+    std::fill(_alive.begin() + next, _alive.end(), 0);
+    resetFreeList(next);
+  }
+
+  void ParticlePool::addChannelsTo(ChannelMap& chans) const {
+    for (const auto& name : _names) {
+      chans.addIfMissing(name);
+    }
+  }
+
+  void ParticlePool::flush(CHOP_Output* output) {
+    if (output == nullptr) {
+      return;
+    }
+    if (!_outputIndices.matches(output->names, output->numChannels)) {
+      std::vector<const std::string*> wanted;
+      for (const auto& name : _names) {
+        wanted.push_back(&name);
+      }
+      _outputIndices.resolve(output->names, output->numChannels, wanted);
+    }
+    auto indices = _outputIndices.data();
+    auto numSamples = std::max(output->numSamples, 0);
+    auto count = std::min(numSamples, _capacity);
+    for (int32_t channel = 0; channel < channelCount(); channel++) {
+      if (indices[channel] < 0) {
+        continue;
+      }
+      auto dest = output->channels[indices[channel]];
+      std::memcpy(dest, channelData(channel), sizeof(float) * static_cast<std::size_t>(count));
+      std::fill(dest + count, dest + numSamples, _defaults[channel]);
+    }
+  }
+
+  void ParticlePool::addChannel(const std::string& name, float defaultValue) {
+    _names.push_back(name);
+    _defaults.push_back(defaultValue);
+    _data.resize(_data.size() + _stride, defaultValue);
+    _outputIndices.clear();
+  }
+
+  void ParticlePool::resetSlot(int32_t i) {
+    for (int32_t channel = 0; channel < channelCount(); channel++) {
+      channelData(channel)[i] = _defaults[channel];
+    }
+  }
+
+  void ParticlePool::resetFreeList(int32_t firstFree) {
+    // Spawning takes from the back, so the free slots start out in
+    // descending order, filling an empty pool from the front.
+    _free.clear();
+    for (int32_t i = _capacity - 1; i >= firstFree; i--) {
+      _free.push_back(i);
+    }
+  }
+
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+#include "TDChannels.h"
+
+namespace tekt {
+
+  class ParticlePool;
+
+  namespace impl {
+    /// Allocates on cache line boundaries, so that arrays carved into
+    /// cache-line multiples keep each piece on its own lines.
+    template<typename T>
+    struct CacheLineAllocator {
+      using value_type = T;
+      static constexpr std::size_t alignment = 64;
+
+      CacheLineAllocator() = default;
+      template<typename U>
+      CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+      T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+      }
+      void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(alignment));
+      }
+
+      template<typename U>
+      bool operator==(const CacheLineAllocator<U>&) const { return true; }
+      template<typename U>
+      bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+    };
+  }
+
+  /// Typed access to one field of the particles in a ParticlePool, stored as
+  /// one float channel per component. It refers to the pool that returned it,
+  /// which must outlive it.
+  template<typename T>
+  class ParticleField {
+  public:
+    static constexpr std::size_t N = impl::arity<T>::value;
+
+    ParticleField() = default;
+
+    T get(int32_t i) const {
+      return impl::getSample(inputTuple(), i, T{});
+    }
+    void set(int32_t i, const T& value) {
+      impl::setSample(outputTuple(), i, value);
+    }
+    /// Reads `count` values starting at slot `start` into `dest`.
+    void get(int32_t start, int32_t count, T* dest) const {
+      impl::getSamples(inputTuple(), start, count, dest);
+    }
+    /// Writes `count` values starting at slot `start`.
+    void set(int32_t start, int32_t count, const T* values) {
+      impl::setSamples(outputTuple(), start, count, values);
+    }
+
+    /// The channel that holds component `part` of this field.
+    int32_t channel(std::size_t part = 0) const { return _channel + static_cast<int32_t>(part); }
+  private:
+    friend class ParticlePool;
+
+    ParticleField(ParticlePool* pool, int32_t channel) : _pool(pool), _channel(channel) {}
+
+    InputChannelTuple<N> inputTuple() const;
+    OutputChannelTuple<N> outputTuple() const;
+
+    ParticlePool* _pool = nullptr;
+    int32_t _channel = -1;
+  };
+
+  /// Fixed-capacity storage for particles, with one contiguous float array
+  /// for each output channel. Each slot is either a live particle or empty,
+  /// and empty slots hold the default values of each field, the same as
+  /// OutputChannel::outputDefault().
+  ///
+  /// Spawning and killing take constant time, using a list of free slots.
+  /// Slot indices are stable until compact() is called.
+  class ParticlePool {
+  public:
+    explicit ParticlePool(int32_t capacity);
+
+    // Fields point back at the pool, so it stays where it was created.
+    ParticlePool(const ParticlePool&) = delete;
+    ParticlePool(ParticlePool&&) = delete;
+    ParticlePool& operator=(const ParticlePool&) = delete;
+    ParticlePool& operator=(ParticlePool&&) = delete;
+
+    /// Adds a field stored in one channel per component. Adding a field
+    /// invalidates pointers returned by channelData().
+    template<typename T>
+    ParticleField<T> addField(const std::array<std::string, impl::arity<T>::value>& names, const T& defaults) {
+      constexpr auto n = impl::arity<T>::value;
+      std::array<float, n> values;
+      OutputChannelTuple<n> tuple;
+      for (std::size_t part = 0; part < n; part++) {
+        tuple[part] = &values[part];
+      }
+      impl::setSample(tuple, 0, defaults);
+      auto first = channelCount();
+      for (std::size_t part = 0; part < n; part++) {
+        addChannel(names[part], values[part]);
+      }
+      return ParticleField<T>(this, first);
+    }
+
+    /// Adds a field with the same channel names and defaults as an output
+    /// channel.
+    template<typename T>
+    ParticleField<T> addField(const OutputChannel<T>& channel) {
+      std::array<std::string, impl::arity<T>::value> names;
+      for (std::size_t part = 0; part < names.size(); part++) {
+        names[part] = channel.channelName(part);
+      }
+      return addField<T>(names, channel.defaults());
+    }
+
+    /// Takes a free slot and returns its index, or -1 if the pool is full.
+    /// The slot holds the default value of every field.
+    int32_t spawn();
+
+    /// Frees a slot and resets it to the default value of every field.
+    void kill(int32_t i);
+
+    /// Kills every particle.
+    void clear();
+
+    /// Moves the live particles to the start of the pool, keeping their
+    /// order, so that they occupy slots [0, activeCount()).
+    void compact();
+
+    bool isAlive(int32_t i) const { return _alive[i] != 0; }
+    int32_t capacity() const { return _capacity; }
+    int32_t activeCount() const { return _capacity - static_cast<int32_t>(_free.size()); }
+
+    int32_t channelCount() const { return static_cast<int32_t>(_names.size()); }
+    const std::string& channelName(int32_t channel) const { return _names[channel]; }
+
+    /// Adds each of the pool's channel names to a channel map, for
+    /// describing the CHOP's output.
+    void addChannelsTo(ChannelMap& chans) const;
+
+    float* channelData(int32_t channel) { return _data.data() + static_cast<std::size_t>(channel) * _stride; }
+    const float* channelData(int32_t channel) const { return _data.data() + static_cast<std::size_t>(channel) * _stride; }
+
+    /// Copies every channel into the output channel with the same name. The
+    /// output's names are resolved to indices once and reused while they stay
+    /// the same. Output samples past the pool's capacity get the defaults.
+    void flush(CHOP_Output* output);
+  private:
+    void addChannel(const std::string& name, float defaultValue);
+    void resetSlot(int32_t i);
+    void resetFreeList(int32_t firstFree);
+
+    int32_t _capacity;
+    // Number of floats between the starts of two channels, rounded up to a
+    // whole number of cache lines. With _data allocated on a cache line
+    // boundary, each channel starts on its own line.
+    std::size_t _stride;
+    std::vector<std::string> _names;
+    std::vector<float> _defaults;
+    std::vector<float, impl::CacheLineAllocator<float>> _data;
+    std::vector<uint8_t> _alive;
+    // Free slots, with the next one to spawn at the back.
+    std::vector<int32_t> _free;
+    impl::ChannelBindingIndices _outputIndices;
+  };
+
+  template<typename T>
+  InputChannelTuple<ParticleField<T>::N> ParticleField<T>::inputTuple() const {
+    assert(_pool != nullptr);
+    InputChannelTuple<N> tuple;
+    for (std::size_t part = 0; part < N; part++) {
+      tuple[part] = _pool->channelData(channel(part));
+    }
+    return tuple;
+  }
+
+  template<typename T>
+  OutputChannelTuple<ParticleField<T>::N> ParticleField<T>::outputTuple() const {
+    assert(_pool != nullptr);
+    OutputChannelTuple<N> tuple;
+    for (std::size_t part = 0; part < N; part++) {
+      tuple[part] = _pool->channelData(channel(part));
+    }
+    return tuple;
+  }
+
+}
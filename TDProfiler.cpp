@@ -0,0 +1,180 @@
+#include "TDProfiler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace {
+
+  const char* const statNames[] = { "last", "min", "avg", "max", "p99" };
+  constexpr int32_t numStats = 5;
+  const char* const columnNames[] = { "section", "samples", "last", "min", "avg", "max", "p99" };
+  constexpr int32_t numColumns = 7;
+
+  // Section names use dots ("params.load"), which aren't valid in channel
+  // names.
+  std::string channelName(const std::string& section, const char* stat) {
+    std::string name;
+    for (char c : section) {
+      name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    name += '_';
+    name += stat;
+    return name;
+  }
+
+  double toMillis(int64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1.0e6;
+  }
+
+}
+
+namespace tekt {
+
+  ProfileSection::ProfileSection(std::string name)
+    : _name(std::move(name)) {
+    for (int32_t i = 0; i < numStats; i++) {
+      _channelNames[i] = channelName(_name, statNames[i]);
+    }
+  }
+
+  void ProfileSection::record(int64_t nanoseconds) {
+    if (_count == windowSize) {
+      _sum -= _samples[_next];
+    } else {
+      _count++;
+    }
+    _samples[_next] = nanoseconds;
+    _sum += nanoseconds;
+    _next = (_next + 1) % windowSize;
+    _dirty = true;
+  }
+
+  void ProfileSection::clear() {
+    _next = 0;
+    _count = 0;
+    _sum = 0;
+    _min = _max = _p99 = 0;
+    _dirty = false;
+  }
+
+  int64_t ProfileSection::last() const {
+    if (_count == 0) {
+      return 0;
+    }
+    return _samples[(_next + windowSize - 1) % windowSize];
+  }
+
+  double ProfileSection::average() const {
+    if (_count == 0) {
+      return 0;
+    }
+    return static_cast<double>(_sum) / static_cast<double>(_count);
+  }
+
+  void ProfileSection::refresh() const {
+    if (!_dirty) {
+      return;
+    }
+    _dirty = false;
+    if (_count == 0) {
+      _min = 0;
+      _max = 0;
+      _p99 = 0;
+      return;
+    }
+    std::array<int64_t, windowSize> sorted{};
+    std::copy_n(_samples.begin(), _count, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + _count);
+    _min = sorted[0];
+    _max = sorted[_count - 1];
+    auto rank = (_count * 99 + 99) / 100;
+    _p99 = sorted[rank - 1];
+  }
+
+  ProfileSection& Profiler::section(std::string_view name) {
+    auto iter = _sectionsByName.find(name);
+    if (iter != _sectionsByName.end()) {
+      return *iter->second;
+    }
+    _sections.push_back(std::make_unique<ProfileSection>(std::string(name)));
+    auto section = _sections.back().get();
+    _sectionsByName.emplace(section->name(), section);
+    return *section;
+  }
+
+  const ProfileSection* Profiler::find(std::string_view name) const {
+    auto iter = _sectionsByName.find(name);
+    return iter == _sectionsByName.end() ? nullptr : iter->second;
+  }
+
+  void Profiler::clear() {
+    for (auto& section : _sections) {
+      section->clear();
+    }
+  }
+
+  int32_t Profiler::getNumInfoCHOPChans() const {
+    return static_cast<int32_t>(_sections.size()) * numStats;
+  }
+
+  bool Profiler::getInfoCHOPChan(int32_t index, OP_InfoCHOPChan* chan) const {
+    if (index < 0 || index >= getNumInfoCHOPChans()) {
+      return false;
+    }
+    const auto& section = *_sections[index / numStats];
+    auto stat = index % numStats;
+    double value = 0;
+    switch (stat) {
+      case 0: value = toMillis(section.last()); break;
+      case 1: value = toMillis(section.min()); break;
+      case 2: value = section.average() / 1.0e6; break;
+      case 3: value = toMillis(section.max()); break;
+      case 4: value = toMillis(section.p99()); break;
+    }
+    chan->name->setString(section._channelNames[stat].c_str());
+    chan->value = static_cast<float>(value);
+    return true;
+  }
+
+  bool Profiler::getInfoDATSize(OP_InfoDATSize* infoSize) const {
+    infoSize->rows = static_cast<int32_t>(_sections.size()) + 1;
+    infoSize->cols = numColumns;
+    infoSize->byColumn = false;
+    return true;
+  }
+
+  void Profiler::getInfoDATEntries(int32_t index, int32_t nEntries, OP_InfoDATEntries* entries) const {
+    auto count = std::min(nEntries, numColumns);
+    if (index == 0) {
+      for (int32_t i = 0; i < count; i++) {
+        entries->values[i]->setString(columnNames[i]);
+      }
+      return;
+    }
+    if (index > static_cast<int32_t>(_sections.size())) {
+      return;
+    }
+    const auto& section = *_sections[index - 1];
+    double stats[] = {
+      static_cast<double>(section.sampleCount()),
+      toMillis(section.last()),
+      toMillis(section.min()),
+      section.average() / 1.0e6,
+      toMillis(section.max()),
+      toMillis(section.p99()),
+    };
+    char buffer[32];
+    for (int32_t i = 0; i < count; i++) {
+      if (i == 0) {
+        entries->values[i]->setString(section.name().c_str());
+      } else if (i == 1) {
+        std::snprintf(buffer, sizeof(buffer), "%.0f", stats[0]);
+        entries->values[i]->setString(buffer);
+      } else {
+        std::snprintf(buffer, sizeof(buffer), "%.4f", stats[i - 1]);
+        entries->values[i]->setString(buffer);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "CPlusPlus_Common.h"
+
+namespace tekt {
+
+  /// Timing statistics for one named stage of a cook, such as "params.load",
+  /// over the most recent `windowSize` runs of it.
+  class ProfileSection {
+  public:
+    static constexpr std::size_t windowSize = 128;
+
+    explicit ProfileSection(std::string name);
+
+    void record(int64_t nanoseconds);
+    void clear();
+
+    const std::string& name() const { return _name; }
+    std::size_t sampleCount() const { return _count; }
+
+    // All of the times are in nanoseconds.
+    int64_t last() const;
+    int64_t min() const { refresh(); return _min; }
+    int64_t max() const { refresh(); return _max; }
+    double average() const;
+    int64_t p99() const { refresh(); return _p99; }
+  private:
+    friend class Profiler;
+
+    void refresh() const;
+
+    std::string _name;
+    // Info CHOP channel names, one for each statistic.
+    std::array<std::string, 5> _channelNames;
+
+    std::array<int64_t, windowSize> _samples;
+    std::size_t _next = 0;
+    std::size_t _count = 0;
+    int64_t _sum = 0;
+
+    mutable bool _dirty = false;
+    mutable int64_t _min = 0;
+    mutable int64_t _max = 0;
+    mutable int64_t _p99 = 0;
+  };
+
+  /// Collects the time spent in named sections of an OP's cook, and
+  /// publishes the statistics through the OP's Info CHOP and Info DAT.
+  ///
+  /// A profiler should only be used from the cook thread.
+  class Profiler {
+  public:
+    /// Times the enclosing block and records it into a section.
+    class Scope {
+    public:
+      explicit Scope(ProfileSection& section)
+        : _section(&section), _start(std::chrono::steady_clock::now()) {}
+      Scope(Profiler& profiler, std::string_view name)
+        : Scope(profiler.section(name)) {}
+      ~Scope() {
+        auto elapsed = std::chrono::steady_clock::now() - _start;
+        _section->record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+      }
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+    private:
+      ProfileSection* _section;
+      std::chrono::steady_clock::time_point _start;
+    };
+
+    /// Finds or adds the section with the given name. The reference stays
+    /// valid for the life of the profiler, so it can be looked up once and
+    /// kept.
+    ProfileSection& section(std::string_view name);
+    const ProfileSection* find(std::string_view name) const;
+
+    /// Clears the statistics of every section.
+    void clear();
+
+    // These have the same signatures as the corresponding CHOP/DAT/SOP/TOP
+    // methods, and can be called directly from them.
+    // The Info CHOP gets a <section>_last/min/avg/max/p99 channel for each
+    // section, in milliseconds. The Info DAT gets a row for each section.
+
+    int32_t getNumInfoCHOPChans() const;
+
+    /// Fills in the channel and returns true if `index` is one of the
+    /// profiler's channels. Indices past getNumInfoCHOPChans() are left for
+    /// the OP's own channels.
+    bool getInfoCHOPChan(int32_t index, OP_InfoCHOPChan* chan) const;
+
+    bool getInfoDATSize(OP_InfoDATSize* infoSize) const;
+    void getInfoDATEntries(int32_t index, int32_t nEntries, OP_InfoDATEntries* entries) const;
+  private:
+    std::vector<std::unique_ptr<ProfileSection>> _sections;
+    std::unordered_map<std::string_view, ProfileSection*> _sectionsByName;
+  };
+
+}
@@ -0,0 +1,76 @@
+#include "TDSOPInput.h"
+
+namespace tekt {
+
+  void SOPInputReader::attach(const OP_SOPInput* input) {
+    if (input == nullptr) {
+      detach();
+      return;
+    }
+    if (input->opId != _opId || input->totalCooks != _totalCooks) {
+      resolve(input);
+    }
+    _input = input;
+    _opId = input->opId;
+    _totalCooks = input->totalCooks;
+
+    auto numPoints = input->getNumPoints();
+    _positions = { input->getPointPositions(), numPoints };
+    auto normals = input->getNormals();
+    _normals = normals == nullptr ? AttributeSpan<Vector>() : AttributeSpan<Vector>(normals->normals, normals->numNormals);
+    auto colors = input->getColors();
+    _colors = colors == nullptr ? AttributeSpan<Color>() : AttributeSpan<Color>(colors->colors, colors->numColors);
+    auto textures = input->getTextures();
+    if (textures == nullptr) {
+      _texCoords = {};
+      _texCoordLayers = 0;
+    } else {
+      _texCoords = { textures->textures, textures->numTextures };
+      _texCoordLayers = textures->numTextureLayers;
+    }
+    _primitives = { input->myPrimsInfo, input->getNumPrimitives() };
+    _primPointIndices = { input->myPrimPointIndices, input->getNumVertices() };
+
+    for (auto attribute : _attributes) {
+      auto data = attribute->_index < 0 ? nullptr : input->getCustomAttribute(attribute->_index);
+      attribute->bind(data, numPoints);
+    }
+  }
+
+  void SOPInputReader::detach() {
+    _input = nullptr;
+    _positions = {};
+    _normals = {};
+    _colors = {};
+    _texCoords = {};
+    _texCoordLayers = 0;
+    _primitives = {};
+    _primPointIndices = {};
+    for (auto attribute : _attributes) {
+      attribute->bind(nullptr, 0);
+    }
+  }
+
+  void SOPInputReader::resolve(const OP_SOPInput* input) {
+    auto count = input->getNumCustomAttributes();
+    for (auto attribute : _attributes) {
+      auto& index = attribute->_index;
+      // Attributes usually stay at the same index when the input recooks.
+      if (index >= 0 && index < count) {
+        auto data = input->getCustomAttribute(index);
+        if (data != nullptr && data->name != nullptr && attribute->name() == data->name) {
+          continue;
+        }
+      }
+      index = -1;
+      for (int32_t i = 0; i < count; i++) {
+        auto data = input->getCustomAttribute(i);
+        if (data != nullptr && data->name != nullptr && attribute->name() == data->name) {
+          index = i;
+          break;
+        }
+      }
+    }
+  }
+
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Parallel.h"
+#include "SOP_CPlusPlusBase.h"
+#include "TDValues.h"
+
+namespace tekt {
+
+  /// A read-only view of an array of SOP attribute values. Indices are only
+  /// checked in debug builds.
+  template<typename T>
+  class AttributeSpan {
+  public:
+    AttributeSpan() = default;
+    AttributeSpan(const T* data, int32_t size) : _data(data), _size(data == nullptr ? 0 : size) {}
+
+    const T& operator[](int32_t i) const {
+      assert(i >= 0 && i < _size);
+      return _data[i];
+    }
+
+    const T* data() const { return _data; }
+    int32_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+
+    /// The values [start, start + count).
+    AttributeSpan subspan(int32_t start, int32_t count) const {
+      assert(start >= 0 && count >= 0 && start + count <= _size);
+      return AttributeSpan(_data + start, count);
+    }
+  private:
+    const T* _data = nullptr;
+    int32_t _size = 0;
+  };
+
+  class SOPInputReader;
+
+  class SOPAttributeBase {
+  public:
+    explicit SOPAttributeBase(std::string name) : _name(std::move(name)) {}
+    virtual ~SOPAttributeBase() = default;
+
+    const std::string& name() const { return _name; }
+  protected:
+    /// Binds to the attribute's data, or to nothing if `data` is null or has
+    /// the wrong type or number of components.
+    virtual void bind(const SOP_CustomAttribData* data, int32_t numPoints) = 0;
+  private:
+    friend class SOPInputReader;
+
+    const std::string _name;
+    // Index of the attribute in the input that it was last found at.
+    int32_t _index = -1;
+  };
+
+  /// Typed access to a named custom point attribute of a SOP input, which is
+  /// resolved by a SOPInputReader. Float and int attributes with one
+  /// component, Vector attributes with three and Color attributes with four
+  /// are supported.
+  template<typename T>
+  class SOPAttribute final : public SOPAttributeBase {
+  public:
+    static constexpr int32_t N = static_cast<int32_t>(impl::arity<T>::value);
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, int32_t> ||
+                  std::is_same_v<T, Vector> || std::is_same_v<T, Color>,
+                  "Unsupported attribute type");
+
+    SOPAttribute(std::string name, T defaults)
+      : SOPAttributeBase(std::move(name)), _defaults(defaults) {}
+
+    bool isPresent() const { return _data != nullptr; }
+    AttributeSpan<T> values() const { return { _data, _size }; }
+
+    /// The value for a point, or the default if the attribute is missing.
+    T get(int32_t i) const {
+      if (_data == nullptr) {
+        return _defaults;
+      }
+      assert(i >= 0 && i < _size);
+      return _data[i];
+    }
+
+    const T& defaults() const { return _defaults; }
+  protected:
+    void bind(const SOP_CustomAttribData* data, int32_t numPoints) override {
+      _data = nullptr;
+      _size = 0;
+      if (data == nullptr || data->numComponents != N) {
+        return;
+      }
+      if constexpr (std::is_same_v<T, int32_t>) {
+        if (data->attribType == AttribType::Int) {
+          _data = data->intData;
+        }
+      } else if (data->attribType == AttribType::Float) {
+        // Vector and Color have the same layout as their packed components.
+        _data = reinterpret_cast<const T*>(data->floatData);
+      }
+      _size = _data == nullptr ? 0 : numPoints;
+    }
+  private:
+    const T _defaults;
+    const T* _data = nullptr;
+    int32_t _size = 0;
+  };
+
+  using FloatSOPAttribute = SOPAttribute<float>;
+  using IntSOPAttribute = SOPAttribute<int32_t>;
+  using VectorSOPAttribute = SOPAttribute<Vector>;
+  using ColorSOPAttribute = SOPAttribute<Color>;
+
+  /// Reads the geometry of a SOP input, along with a set of named custom
+  /// attributes. The attributes are found by name only when the input has
+  /// cooked since the last attach(), and otherwise by the index they were
+  /// found at before.
+  class SOPInputReader {
+  public:
+    SOPInputReader() = default;
+    SOPInputReader(std::initializer_list<SOPAttributeBase*> attributes) {
+      for (auto attribute : attributes) {
+        add(*attribute);
+      }
+    }
+
+    SOPInputReader& add(SOPAttributeBase& attribute) {
+      _attributes.push_back(&attribute);
+      _totalCooks = -1;
+      return *this;
+    }
+
+    /// Binds to the input's current data. Must be called on each cook
+    /// before reading, since the data can move between cooks.
+    void attach(const OP_SOPInput* input);
+    void detach();
+
+    bool isAttached() const { return _input != nullptr; }
+    const OP_SOPInput* input() const { return _input; }
+
+    int32_t numPoints() const { return _positions.size(); }
+    AttributeSpan<Position> positions() const { return _positions; }
+    /// Point normals, which are empty if the input has none.
+    AttributeSpan<Vector> normals() const { return _normals; }
+    AttributeSpan<Color> colors() const { return _colors; }
+    /// Point texture coordinates, with texCoordLayers() values for each
+    /// point, back to back.
+    AttributeSpan<TexCoord> texCoords() const { return _texCoords; }
+    int32_t texCoordLayers() const { return _texCoordLayers; }
+
+    AttributeSpan<SOP_PrimitiveInfo> primitives() const { return _primitives; }
+    /// The point indices of every primitive, back to back, which is
+    /// getNumVertices() long.
+    AttributeSpan<int32_t> primitivePointIndices() const { return _primPointIndices; }
+
+    /// Calls body(begin, end) for chunks of the points, on the shared thread
+    /// pool, for processing the points in parallel.
+    template<typename F>
+    void forEachChunk(F&& body, int32_t grain = parallelGrain) const {
+      parallelForRange(0, numPoints(), std::forward<F>(body), grain);
+    }
+  private:
+    void resolve(const OP_SOPInput* input);
+
+    std::vector<SOPAttributeBase*> _attributes;
+    const OP_SOPInput* _input = nullptr;
+    uint32_t _opId = 0;
+    int64_t _totalCooks = -1;
+
+    AttributeSpan<Position> _positions;
+    AttributeSpan<Vector> _normals;
+    AttributeSpan<Color> _colors;
+    AttributeSpan<TexCoord> _texCoords;
+    int32_t _texCoordLayers = 0;
+    AttributeSpan<SOP_PrimitiveInfo> _primitives;
+    AttributeSpan<int32_t> _primPointIndices;
+  };
+
+}
@@ -4,9 +4,6 @@ namespace tekt {
 
   void ParamGroup::add(Parameter& par) {
     _params.push_back(&par);
-    if (par.isPulse()) {
-      _pulses[par.name] = dynamic_cast<PulseParameter*>(&par);
-    }
   }
 
   void ParamGroup::create(OP_ParameterManager* parManager) {
@@ -17,14 +14,21 @@ namespace tekt {
   }
 
   void ParamGroup::load(const OP_Inputs& inputs) {
+    _changed = false;
     for (auto& par : _params) {
       par->load(inputs);
+      _changed |= par->hasChanged();
     }
   }
 
   void Settings::add(ParamGroup& group) {
     _groups.push_back(&group);
-    _pulses.insert(group._pulses.begin(), group._pulses.end());
+    for (auto par : group._params) {
+      _paramsByName[par->name] = par;
+      if (auto pulse = par->asPulse()) {
+        _pulses[pulse->name] = pulse;
+      }
+    }
   }
 
   void Settings::create(OP_ParameterManager* parManager) {
@@ -33,14 +37,32 @@ namespace tekt {
     }
   }
 
+  OP_ParAppendResult Settings::create(OP_ParameterManager* parManager, ParTable& table) {
+    if (table.empty()) {
+      create(&table);
+    }
+    auto result = table.replay(parManager);
+    return table.status() != OP_ParAppendResult::Success ? table.status() : result;
+  }
+
   void Settings::load(const OP_Inputs& inputs) {
+    _changed = false;
     for (auto& group : _groups) {
       group->load(inputs);
+      _changed |= group->hasChanged();
+    }
+  }
+
+  Parameter* Settings::find(std::string_view name) const {
+    auto iter = _paramsByName.find(name);
+    if (iter == _paramsByName.end()) {
+      return nullptr;
     }
+    return iter->second;
   }
 
   bool Settings::handlePulse(const char* name) {
-    auto iter = _pulses.find(name);
+    auto iter = _pulses.find(std::string_view(name));
     if (iter == _pulses.end()) {
       return false;
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include "CHOP_CPlusPlusBase.h"
@@ -15,6 +16,9 @@ namespace tekt {
     virtual ~ParamGroup() = default;
     virtual void create(OP_ParameterManager* parManager);
     virtual void load(const OP_Inputs& inputs);
+
+    /// Whether any of the group's parameters changed in the most recent load.
+    bool hasChanged() const { return _changed; }
   protected:
     void add(Parameter& par);
     void add(VectorRangeParameters& pars) {
@@ -24,7 +28,7 @@ namespace tekt {
   private:
     const std::string _page;
     std::vector<Parameter*> _params;
-    std::unordered_map<std::string, PulseParameter*> _pulses;
+    bool _changed = true;
 
     friend class Settings;
   };
@@ -33,14 +37,32 @@ namespace tekt {
   public:
     virtual ~Settings() = default;
     virtual void create(OP_ParameterManager* parManager);
+    /// Creates the parameters by replaying a table, which is recorded from
+    /// the other create() the first time. The table can be a static shared
+    /// by every instance of an OP, as long as they all define the same
+    /// parameters. Subclasses that override create() need
+    /// `using Settings::create;` to keep this overload visible. Returns the
+    /// first failure from recording or replaying the parameters, if any.
+    OP_ParAppendResult create(OP_ParameterManager* parManager, ParTable& table);
     virtual void load(const OP_Inputs& inputs);
     bool handlePulse(const char* name);
     void resetPulses();
+
+    /// Finds a parameter by name, or returns nullptr if there isn't one.
+    Parameter* find(std::string_view name) const;
+
+    /// Whether any parameter in any group changed in the most recent load.
+    /// Use ParamGroup::hasChanged() to find out which groups changed.
+    bool hasChanged() const { return _changed; }
   protected:
     void add(ParamGroup& group);
   private:
     std::vector<ParamGroup*> _groups;
-    std::unordered_map<std::string, PulseParameter*> _pulses;
+    bool _changed = true;
+    // Keyed by views of the parameters' own names, so that lookups by a
+    // const char* from the host don't need to allocate a std::string.
+    std::unordered_map<std::string_view, Parameter*> _paramsByName;
+    std::unordered_map<std::string_view, PulseParameter*> _pulses;
   };
 
 }
@@ -0,0 +1,326 @@
+#include "TDSpatialGrid.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include "Parallel.h"
+#include "Simd.h"
+
+namespace {
+
+  // Points are handed to the threads in chunks of at least this many, since
+  // the work per point is small.
+  constexpr int32_t buildGrain = 1024;
+
+  // Below this many points, splitting the build costs more than it saves.
+  constexpr int32_t minParallelBuild = 16 * buildGrain;
+
+  bool shouldBuildInParallel(int32_t count) {
+    return count >= minParallelBuild && tekt::ThreadPool::shared().threadCount() > 1;
+  }
+
+  struct Bounds {
+    float low[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float high[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    // NaN and infinite components are left out, and end up in the edge cells.
+    void include(float value, int axis) {
+      if (value >= -FLT_MAX && value <= FLT_MAX) {
+        low[axis] = std::min(low[axis], value);
+        high[axis] = std::max(high[axis], value);
+      }
+    }
+
+    void include(const Position* points, int32_t begin, int32_t end) {
+      for (auto i = begin; i < end; i++) {
+        include(points[i].x, 0);
+        include(points[i].y, 1);
+        include(points[i].z, 2);
+      }
+    }
+
+    void include(const Bounds& other) {
+      for (int axis = 0; axis < 3; axis++) {
+        low[axis] = std::min(low[axis], other.low[axis]);
+        high[axis] = std::max(high[axis], other.high[axis]);
+      }
+    }
+  };
+
+  float component(const Position& p, int axis) {
+    return axis == 0 ? p.x : axis == 1 ? p.y : p.z;
+  }
+
+}
+
+namespace tekt {
+
+  SpatialGrid::SpatialGrid(float cellSize)
+    : _cellSize(cellSize) {
+    assert(cellSize > 0.0f);
+  }
+
+  void SpatialGrid::build(const Position* points, int32_t count) {
+    layout(points, count, false);
+  }
+
+  void SpatialGrid::build(const InputChannel<Vector>& positions, int32_t count) {
+    layout(stage(positions, count, false), count, false);
+  }
+
+  void SpatialGrid::buildParallel(const Position* points, int32_t count) {
+    layout(points, count, shouldBuildInParallel(count));
+  }
+
+  void SpatialGrid::buildParallel(const InputChannel<Vector>& positions, int32_t count) {
+    auto parallel = shouldBuildInParallel(count);
+    layout(stage(positions, count, parallel), count, parallel);
+  }
+
+  const Position* SpatialGrid::stage(const InputChannel<Vector>& positions, int32_t count, bool parallel) {
+    count = std::max(count, 0);
+    _staging.resize(static_cast<std::size_t>(count));
+    if (!positions.areAllPresent()) {
+      const auto& value = positions.defaults();
+      std::fill(_staging.begin(), _staging.end(), Position(value.x, value.y, value.z));
+      return _staging.data();
+    }
+    const auto& data = positions.data();
+    auto copy = [&](int32_t begin, int32_t end) {
+      interleave(data[0] + begin, data[1] + begin, data[2] + begin,
+                 _staging.data() + begin, static_cast<std::size_t>(end - begin));
+    };
+    if (parallel) {
+      parallelForRange(0, count, copy, buildGrain);
+    } else {
+      copy(0, count);
+    }
+    return _staging.data();
+  }
+
+  void SpatialGrid::layout(const Position* points, int32_t count, bool parallel) {
+    count = std::max(count, 0);
+    auto size = static_cast<std::size_t>(count);
+    _order.resize(size);
+    _points.resize(size);
+    _cellOf.resize(size);
+
+    Bounds bounds;
+    if (parallel) {
+      std::mutex mutex;
+      parallelForRange(0, count, [&](int32_t begin, int32_t end) {
+        Bounds chunk;
+        chunk.include(points, begin, end);
+        std::lock_guard<std::mutex> lock(mutex);
+        bounds.include(chunk);
+      }, buildGrain);
+    } else {
+      bounds.include(points, 0, count);
+    }
+    setGrid(bounds.low, bounds.high, count);
+
+    auto numCells = _dims[0] * _dims[1] * _dims[2];
+    _cellStart.assign(static_cast<std::size_t>(numCells) + 1, 0);
+
+    if (!parallel) {
+      for (int32_t i = 0; i < count; i++) {
+        auto cell = cellOf(points[i]);
+        _cellOf[i] = cell;
+        _cellStart[cell + 1]++;
+      }
+      for (int32_t cell = 0; cell < numCells; cell++) {
+        _cellStart[cell + 1] += _cellStart[cell];
+      }
+      // Each cell's start is used as its cursor, which leaves it at the
+      // start of the next cell, so they're shifted back afterwards.
+      for (int32_t i = 0; i < count; i++) {
+        auto slot = _cellStart[_cellOf[i]]++;
+        _order[slot] = i;
+        _points[slot] = points[i];
+      }
+      for (auto cell = numCells; cell > 0; cell--) {
+        _cellStart[cell] = _cellStart[cell - 1];
+      }
+      _cellStart[0] = 0;
+      return;
+    }
+
+    if (_counterCapacity < static_cast<std::size_t>(numCells)) {
+      _counterCapacity = static_cast<std::size_t>(numCells);
+      _counters = std::make_unique<std::atomic<int32_t>[]>(_counterCapacity);
+    }
+    auto counters = _counters.get();
+    parallelForRange(0, numCells, [&](int32_t begin, int32_t end) {
+      for (auto cell = begin; cell < end; cell++) {
+        counters[cell].store(0, std::memory_order_relaxed);
+      }
+    }, buildGrain);
+    parallelForRange(0, count, [&](int32_t begin, int32_t end) {
+      for (auto i = begin; i < end; i++) {
+        auto cell = cellOf(points[i]);
+        _cellOf[i] = cell;
+        counters[cell].fetch_add(1, std::memory_order_relaxed);
+      }
+    }, buildGrain);
+    int32_t total = 0;
+    for (int32_t cell = 0; cell < numCells; cell++) {
+      auto n = counters[cell].load(std::memory_order_relaxed);
+      _cellStart[cell] = total;
+      counters[cell].store(total, std::memory_order_relaxed);
+      total += n;
+    }
+    _cellStart[numCells] = total;
+    parallelForRange(0, count, [&](int32_t begin, int32_t end) {
+      for (auto i = begin; i < end; i++) {
+        _order[counters[_cellOf[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+      }
+    }, buildGrain);
+    // The threads fill each cell in any order, so the cells are sorted to
+    // give the same order as the serial build.
+    parallelForRange(0, numCells, [&](int32_t begin, int32_t end) {
+      for (auto cell = begin; cell < end; cell++) {
+        auto first = _cellStart[cell];
+        auto last = _cellStart[cell + 1];
+        std::sort(_order.begin() + first, _order.begin() + last);
+        for (auto k = first; k < last; k++) {
+          _points[k] = points[_order[k]];
+        }
+      }
+    }, buildGrain);
+  }
+
+  void SpatialGrid::setGrid(const float* low, const float* high, int32_t count) {
+    // Keeping the number of cells in proportion to the number of points
+    // bounds the memory and the time spent on empty cells.
+    const double maxCells = std::min(std::max(2.0 * count, 64.0), 1073741824.0);
+    double extent[3];
+    double largest = 0.0;
+    for (int axis = 0; axis < 3; axis++) {
+      if (low[axis] > high[axis]) {
+        // No finite values.
+        _low[axis] = 0.0f;
+        extent[axis] = 0.0;
+      } else {
+        _low[axis] = low[axis];
+        extent[axis] = static_cast<double>(high[axis]) - low[axis];
+      }
+      largest = std::max(largest, extent[axis]);
+    }
+    double cell = _cellSize;
+    for (int attempt = 0; ; attempt++) {
+      double dims[3];
+      double total = 1.0;
+      for (int axis = 0; axis < 3; axis++) {
+        dims[axis] = std::min(std::floor(extent[axis] / cell) + 1.0, maxCells);
+        total *= dims[axis];
+      }
+      if (total <= maxCells) {
+        for (int axis = 0; axis < 3; axis++) {
+          _dims[axis] = static_cast<int32_t>(dims[axis]);
+        }
+        break;
+      }
+      // A cell as big as the whole extent always fits, with 8 cells at most.
+      cell = attempt < 8 ? cell * std::cbrt(total / maxCells) * 1.01 : largest;
+    }
+    _cell = static_cast<float>(cell);
+    _invCell = static_cast<float>(1.0 / cell);
+  }
+
+  void SpatialGrid::cellRange(const Position& center, float radius, int32_t* low, int32_t* high) const {
+    for (int axis = 0; axis < 3; axis++) {
+      auto value = component(center, axis);
+      low[axis] = cellCoord(value - radius, axis);
+      high[axis] = cellCoord(value + radius, axis);
+    }
+  }
+
+  void SpatialGrid::findInRadius(const Position& center, float radius, std::vector<Neighbor>& result,
+                                 int32_t exclude) const {
+    result.clear();
+    forEachInRadius(center, radius, [&](int32_t index, float distanceSquared) {
+      if (index != exclude) {
+        result.push_back({ index, distanceSquared });
+      }
+    });
+  }
+
+  int32_t SpatialGrid::findNearest(const Position& center, int32_t k, Neighbor* result, int32_t exclude) const {
+    if (k <= 0 || _order.empty()) {
+      return 0;
+    }
+    int32_t found = 0;
+    // Keeps the nearest k points found so far in result, sorted by distance.
+    auto consider = [&](int32_t begin, int32_t end) {
+      for (auto j = begin; j < end; j++) {
+        auto index = _order[j];
+        auto d = distanceSquared(_points[j], center);
+        if (index == exclude || !(d >= 0.0f)) {
+          continue;
+        }
+        if (found == k && !(d < result[k - 1].distanceSquared)) {
+          continue;
+        }
+        auto slot = found < k ? found++ : k - 1;
+        while (slot > 0 && result[slot - 1].distanceSquared > d) {
+          result[slot] = result[slot - 1];
+          slot--;
+        }
+        result[slot] = { index, d };
+      }
+    };
+
+    int32_t c[3];
+    for (int axis = 0; axis < 3; axis++) {
+      c[axis] = cellCoord(component(center, axis), axis);
+    }
+    // Searches shells of cells around the center's cell, moving outwards
+    // until the k points found are nearer than anything outside the shell.
+    for (int32_t ring = 0; ; ring++) {
+      int32_t low[3];
+      int32_t high[3];
+      bool coversGrid = true;
+      for (int axis = 0; axis < 3; axis++) {
+        low[axis] = std::max(c[axis] - ring, 0);
+        high[axis] = std::min(c[axis] + ring, _dims[axis] - 1);
+        coversGrid = coversGrid && c[axis] - ring <= 0 && c[axis] + ring >= _dims[axis] - 1;
+      }
+      for (auto z = low[2]; z <= high[2]; z++) {
+        for (auto y = low[1]; y <= high[1]; y++) {
+          auto row = (z * _dims[1] + y) * _dims[0];
+          if (z == c[2] - ring || z == c[2] + ring || y == c[1] - ring || y == c[1] + ring) {
+            consider(_cellStart[row + low[0]], _cellStart[row + high[0] + 1]);
+          } else {
+            // Inside the shell's faces, only the cells at either end of the
+            // row are on the shell.
+            if (c[0] - ring >= 0) {
+              consider(_cellStart[row + c[0] - ring], _cellStart[row + c[0] - ring + 1]);
+            }
+            if (c[0] + ring < _dims[0]) {
+              consider(_cellStart[row + c[0] + ring], _cellStart[row + c[0] + ring + 1]);
+            }
+          }
+        }
+      }
+      if (coversGrid) {
+        break;
+      }
+      if (found == k) {
+        // Anything outside the searched cells is at least this far away.
+        auto bound = std::numeric_limits<float>::infinity();
+        for (int axis = 0; axis < 3; axis++) {
+          auto value = component(center, axis);
+          auto boxLow = _low[axis] + static_cast<float>(c[axis] - ring) * _cell;
+          auto boxHigh = _low[axis] + static_cast<float>(c[axis] + ring + 1) * _cell;
+          bound = std::min(bound, std::min(value - boxLow, boxHigh - value));
+        }
+        if (bound > 0.0f && bound * bound >= result[k - 1].distanceSquared) {
+          break;
+        }
+      }
+    }
+    return found;
+  }
+
+}
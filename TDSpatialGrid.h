@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "TDChannels.h"
+
+namespace tekt {
+
+  /// A point found by a SpatialGrid query.
+  struct Neighbor {
+    int32_t index;
+    float distanceSquared;
+  };
+
+  /// A uniform grid over a set of points, such as the particle positions in
+  /// a CHOP's input channels, for finding the points near a position without
+  /// testing every point.
+  ///
+  /// Building counting-sorts the point indices by cell, and keeps a copy of
+  /// the positions in the same order, so each row of cells that a query
+  /// visits is one contiguous run of memory. The arrays are kept between
+  /// builds, so rebuilding on each cook doesn't allocate unless the number
+  /// of points grows.
+  ///
+  /// Queries don't modify the grid, so they can be made from parallelFor()
+  /// bodies.
+  class SpatialGrid {
+  public:
+    /// Creates a grid whose cells are `cellSize` wide, which works best at
+    /// around the radius that will be queried. Cells are made larger when
+    /// the points are spread out enough that they would far outnumber the
+    /// points.
+    explicit SpatialGrid(float cellSize);
+
+    void setCellSize(float cellSize) {
+      assert(cellSize > 0.0f);
+      _cellSize = cellSize;
+    }
+    float cellSize() const { return _cellSize; }
+
+    /// Rebuilds the grid from `count` points.
+    void build(const Position* points, int32_t count);
+    /// Rebuilds the grid from the first `count` samples of a channel, or
+    /// from `count` copies of its default if any of its channels are missing.
+    void build(const InputChannel<Vector>& positions, int32_t count);
+
+    /// The same as build(), with the work split across the shared thread
+    /// pool, for large numbers of points. Small sets of points, or a pool
+    /// with a single thread, use build() instead.
+    void buildParallel(const Position* points, int32_t count);
+    void buildParallel(const InputChannel<Vector>& positions, int32_t count);
+
+    int32_t size() const { return static_cast<int32_t>(_order.size()); }
+    bool empty() const { return _order.empty(); }
+
+    /// The point indices sorted by cell, with nearby points close together.
+    /// Looping over the points in this order makes queries for neighboring
+    /// points reuse the same cells.
+    const std::vector<int32_t>& order() const { return _order; }
+
+    /// Calls visit(index, distanceSquared) for each point within `radius`
+    /// of `center`, in no particular order.
+    template<typename F>
+    void forEachInRadius(const Position& center, float radius, F&& visit) const {
+      if (_order.empty() || !(radius >= 0.0f)) {
+        return;
+      }
+      int32_t low[3];
+      int32_t high[3];
+      cellRange(center, radius, low, high);
+      auto radiusSquared = radius * radius;
+      for (int32_t z = low[2]; z <= high[2]; z++) {
+        for (int32_t y = low[1]; y <= high[1]; y++) {
+          // The cells of a row are adjacent, so their points are one run.
+          auto row = (z * _dims[1] + y) * _dims[0];
+          auto end = _cellStart[row + high[0] + 1];
+          for (auto k = _cellStart[row + low[0]]; k < end; k++) {
+            auto d = distanceSquared(_points[k], center);
+            if (d <= radiusSquared) {
+              visit(_order[k], d);
+            }
+          }
+        }
+      }
+    }
+
+    /// Replaces the contents of `result` with the points within `radius` of
+    /// `center`, other than the point with index `exclude`.
+    void findInRadius(const Position& center, float radius, std::vector<Neighbor>& result,
+                      int32_t exclude = -1) const;
+
+    /// Writes up to `k` of the points nearest to `center`, other than the
+    /// point with index `exclude`, to `result`, nearest first. Returns the
+    /// number of points written, which is less than `k` only when the grid
+    /// has fewer points.
+    int32_t findNearest(const Position& center, int32_t k, Neighbor* result, int32_t exclude = -1) const;
+  private:
+    static float distanceSquared(const Position& a, const Position& b) {
+      auto dx = a.x - b.x;
+      auto dy = a.y - b.y;
+      auto dz = a.z - b.z;
+      return dx * dx + dy * dy + dz * dz;
+    }
+
+    // Cell coordinate along an axis, clamped to the grid. NaN goes to 0.
+    int32_t cellCoord(float value, int axis) const {
+      auto f = (value - _low[axis]) * _invCell;
+      if (!(f > 0.0f)) {
+        return 0;
+      }
+      return f < static_cast<float>(_dims[axis]) ? static_cast<int32_t>(f) : _dims[axis] - 1;
+    }
+
+    int32_t cellOf(const Position& p) const {
+      return (cellCoord(p.z, 2) * _dims[1] + cellCoord(p.y, 1)) * _dims[0] + cellCoord(p.x, 0);
+    }
+
+    void cellRange(const Position& center, float radius, int32_t* low, int32_t* high) const;
+    void setGrid(const float* low, const float* high, int32_t count);
+
+    const Position* stage(const InputChannel<Vector>& positions, int32_t count, bool parallel);
+    void layout(const Position* points, int32_t count, bool parallel);
+
+    float _cellSize;
+
+    // The grid's layout from the last build.
+    float _low[3] = { 0.0f, 0.0f, 0.0f };
+    float _cell = 1.0f;
+    float _invCell = 1.0f;
+    int32_t _dims[3] = { 1, 1, 1 };
+
+    // Index into _order/_points of the first point of each cell, plus one
+    // more for the end of the last cell.
+    std::vector<int32_t> _cellStart;
+    std::vector<int32_t> _order;
+    std::vector<Position> _points;
+
+    // Scratch space for building.
+    std::vector<int32_t> _cellOf;
+    std::vector<Position> _staging;
+    std::unique_ptr<std::atomic<int32_t>[]> _counters;
+    std::size_t _counterCapacity = 0;
+  };
+
+}
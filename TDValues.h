@@ -53,6 +53,17 @@ namespace tekt {
     template<>
     inline const float& tupleField<Color, 3>(const Color & t) { return t.a; }
 
+    template<typename T>
+    bool valuesEqual(const T& a, const T& b) { return a == b; }
+
+    inline bool valuesEqual(const Vector& a, const Vector& b) {
+      return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    inline bool valuesEqual(const Color& a, const Color& b) {
+      return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
     template<std::size_t N>
     struct arrayMaker {};
 
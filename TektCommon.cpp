@@ -1,12 +1,38 @@
 #include "TektCommon.h"
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include "Simd.h"
+
+namespace {
+
+  bool isEmptyRange(float inputMin, float inputMax) {
+    return std::fabs(inputMin - inputMax) < FLT_EPSILON;
+  }
+
+  tekt::impl::RemapTerms remapTerms(float inputMin, float inputMax, float outputMin, float outputMax, bool clamp) {
+    return {
+      inputMin,
+      inputMax - inputMin,
+      outputMax - outputMin,
+      outputMin,
+      clamp,
+      std::min(outputMin, outputMax),
+      std::max(outputMin, outputMax),
+    };
+  }
+
+  // Number of values handled at a time by the multi-component forms, sized
+  // so that the temporary component arrays stay in L1 cache.
+  constexpr std::size_t blockSize = 256;
+
+}
 
 namespace tekt {
 
   float remap(float value, float inputMin, float inputMax, float outputMin, float outputMax, bool clamp) {
 
-    if (std::fabs(inputMin - inputMax) < FLT_EPSILON) {
+    if (isEmptyRange(inputMin, inputMax)) {
       return outputMin;
     }
     auto outVal = ((value - inputMin) / (inputMax - inputMin) * (outputMax - outputMin) + outputMin);
@@ -32,4 +58,67 @@ namespace tekt {
       remap(value, inputMin, inputMax, outputMin.z, outputMax.z, clamp)
     };
   }
+
+  void remap(const float* values, float* results, std::size_t count,
+    float inputMin, float inputMax, float outputMin, float outputMax, bool clamp) {
+    if (isEmptyRange(inputMin, inputMax)) {
+      std::fill_n(results, count, outputMin);
+      return;
+    }
+    impl::remapSamples(values, results, count, remapTerms(inputMin, inputMax, outputMin, outputMax, clamp));
+  }
+
+  void remap(float* values, std::size_t count,
+    float inputMin, float inputMax, float outputMin, float outputMax, bool clamp) {
+    remap(values, values, count, inputMin, inputMax, outputMin, outputMax, clamp);
+  }
+
+  void remap(const float* values, Vector* results, std::size_t count,
+    float inputMin, float inputMax, const Vector& outputMin, const Vector& outputMax, bool clamp) {
+    if (isEmptyRange(inputMin, inputMax)) {
+      std::fill_n(results, count, outputMin);
+      return;
+    }
+    auto tx = remapTerms(inputMin, inputMax, outputMin.x, outputMax.x, clamp);
+    auto ty = remapTerms(inputMin, inputMax, outputMin.y, outputMax.y, clamp);
+    auto tz = remapTerms(inputMin, inputMax, outputMin.z, outputMax.z, clamp);
+    alignas(32) float normalized[blockSize];
+    alignas(32) float x[blockSize];
+    alignas(32) float y[blockSize];
+    alignas(32) float z[blockSize];
+    for (std::size_t start = 0; start < count; start += blockSize) {
+      auto n = std::min(blockSize, count - start);
+      impl::normalizeSamples(values + start, normalized, n, tx);
+      impl::scaleSamples(normalized, x, n, tx);
+      impl::scaleSamples(normalized, y, n, ty);
+      impl::scaleSamples(normalized, z, n, tz);
+      interleave(x, y, z, results + start, n);
+    }
+  }
+
+  void remap(const float* values, Color* results, std::size_t count,
+    float inputMin, float inputMax, const Color& outputMin, const Color& outputMax, bool clamp) {
+    if (isEmptyRange(inputMin, inputMax)) {
+      std::fill_n(results, count, outputMin);
+      return;
+    }
+    auto tr = remapTerms(inputMin, inputMax, outputMin.r, outputMax.r, clamp);
+    auto tg = remapTerms(inputMin, inputMax, outputMin.g, outputMax.g, clamp);
+    auto tb = remapTerms(inputMin, inputMax, outputMin.b, outputMax.b, clamp);
+    auto ta = remapTerms(inputMin, inputMax, outputMin.a, outputMax.a, clamp);
+    alignas(32) float normalized[blockSize];
+    alignas(32) float r[blockSize];
+    alignas(32) float g[blockSize];
+    alignas(32) float b[blockSize];
+    alignas(32) float a[blockSize];
+    for (std::size_t start = 0; start < count; start += blockSize) {
+      auto n = std::min(blockSize, count - start);
+      impl::normalizeSamples(values + start, normalized, n, tr);
+      impl::scaleSamples(normalized, r, n, tr);
+      impl::scaleSamples(normalized, g, n, tg);
+      impl::scaleSamples(normalized, b, n, tb);
+      impl::scaleSamples(normalized, a, n, ta);
+      interleave(r, g, b, a, results + start, n);
+    }
+  }
 }
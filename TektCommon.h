@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include "CPlusPlus_Common.h"
 
 namespace tekt {
@@ -12,5 +13,33 @@ namespace tekt {
     const Vector& outputMin, const Vector& outputMax,
     bool clamp = false);
 
-}
+  // The array forms of remap() compute the range terms once and process the
+  // values with vectorized kernels. Their results are identical to calling
+  // the scalar remap() on each value.
+
+  void remap(
+    const float* values, float* results, std::size_t count,
+    float inputMin, float inputMax,
+    float outputMin, float outputMax,
+    bool clamp = false);
 
+  /// Remaps an array of values in place.
+  void remap(
+    float* values, std::size_t count,
+    float inputMin, float inputMax,
+    float outputMin, float outputMax,
+    bool clamp = false);
+
+  void remap(
+    const float* values, Vector* results, std::size_t count,
+    float inputMin, float inputMax,
+    const Vector& outputMin, const Vector& outputMax,
+    bool clamp = false);
+
+  void remap(
+    const float* values, Color* results, std::size_t count,
+    float inputMin, float inputMax,
+    const Color& outputMin, const Color& outputMax,
+    bool clamp = false);
+
+}
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
 #include <utility>
+#include "Simd.h"
 #include "TektCommon.h"
 
 namespace tekt {
@@ -33,5 +38,108 @@ namespace tekt {
       }
       return low + (high - low) * normVal;
     }
+
+    bool operator==(const ValueRange& other) const {
+      return low == other.low && high == other.high;
+    }
+    bool operator!=(const ValueRange& other) const { return !(*this == other); }
+  };
+
+  /// A ValueRange that caches the scale and offset for mapping values to and
+  /// from the normalized range, so that each value costs a single multiply-add.
+  /// The cached terms are recomputed when low or high have changed since they
+  /// were last used.
+  template<typename T>
+  class ValueRangeMapper : public ValueRange<T> {
+    static_assert(std::is_floating_point_v<T>, "ValueRangeMapper requires a floating point type");
+  public:
+    ValueRangeMapper() = default;
+    ValueRangeMapper(T l, T h) : ValueRange<T>(std::move(l), std::move(h)) {}
+    explicit ValueRangeMapper(const ValueRange<T>& range) : ValueRange<T>(range) {}
+
+    /// Recomputes the cached terms if the range has changed. Every mapping
+    /// function does this itself, but it should be called up front when the
+    /// mapper is going to be shared between threads.
+    void prepare() const {
+      if (this->low == _cachedLow && this->high == _cachedHigh) {
+        return;
+      }
+      _cachedLow = this->low;
+      _cachedHigh = this->high;
+      _span = this->high - this->low;
+      if (std::fabs(_span) < std::numeric_limits<T>::epsilon()) {
+        _normScale = 0;
+        _normOffset = 0;
+      } else {
+        _normScale = static_cast<T>(1) / _span;
+        _normOffset = -this->low * _normScale;
+      }
+    }
+
+    bool checkAndNormalize(const T& value, T* result) const
+    {
+      if (value < this->low || value > this->high)
+      {
+        return false;
+      }
+      *result = std::max(static_cast<T>(0), std::min(static_cast<T>(1), normalize(value)));
+      return true;
+    }
+
+    T mapNormalized(T normVal, bool clamp = false) const
+    {
+      if (clamp) {
+        normVal = std::max(normVal, static_cast<T>(0));
+        normVal = std::min(normVal, static_cast<T>(1));
+      }
+      return denormalize(normVal);
+    }
+
+    T normalize(T value) const {
+      prepare();
+      return value * _normScale + _normOffset;
+    }
+
+    T denormalize(T normVal) const {
+      prepare();
+      return normVal * _span + this->low;
+    }
+
+    /// Normalizes an array of values, optionally clamping the results to
+    /// [0, 1].
+    void normalize(const T* values, T* results, std::size_t count, bool clamp = false) const {
+      prepare();
+      apply(values, results, count, _normScale, _normOffset,
+            clamp, static_cast<T>(0), static_cast<T>(1));
+    }
+
+    /// Maps an array of normalized values into the range, optionally clamping
+    /// the results to it.
+    void denormalize(const T* values, T* results, std::size_t count, bool clamp = false) const {
+      prepare();
+      apply(values, results, count, _span, this->low,
+            clamp, std::min(this->low, this->high), std::max(this->low, this->high));
+    }
+  private:
+    static void apply(const T* values, T* results, std::size_t count,
+                      T scale, T offset, bool clamp, T lowest, T highest) {
+      if constexpr (std::is_same_v<T, float>) {
+        impl::scaleSamples(values, results, count, { 0, 1, scale, offset, clamp, lowest, highest });
+      } else {
+        for (std::size_t i = 0; i < count; i++) {
+          T v = values[i] * scale + offset;
+          if (clamp) {
+            v = std::max(lowest, std::min(highest, v));
+          }
+          results[i] = v;
+        }
+      }
+    }
+
+    mutable T _cachedLow = std::numeric_limits<T>::quiet_NaN();
+    mutable T _cachedHigh = std::numeric_limits<T>::quiet_NaN();
+    mutable T _span = 0;
+    mutable T _normScale = 0;
+    mutable T _normOffset = 0;
   };
 }
@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "FrameArena.h"
+
+using namespace tekt;
+
+namespace {
+
+  // Each iteration stands in for a cook that builds a few temporary buffers
+  // whose sizes vary from cook to cook.
+
+  void BM_ScratchHeap(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::size_t cook = 0;
+    for (auto _ : state) {
+      auto n = count + (cook++ % 7) * 13;
+      std::vector<float> a(n);
+      std::vector<int32_t> b;
+      for (std::size_t i = 0; i < n; i++) {
+        b.push_back(static_cast<int32_t>(i));
+      }
+      benchmark::DoNotOptimize(a.data());
+      benchmark::DoNotOptimize(b.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_ScratchHeap)->Arg(100)->Arg(10000);
+
+  void BM_ScratchArena(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    FrameArena arena(1024);
+    std::size_t cook = 0;
+    for (auto _ : state) {
+      arena.reset();
+      auto n = count + (cook++ % 7) * 13;
+      ArenaVector<float> a(n, ArenaAllocator<float>(arena));
+      ArenaVector<int32_t> b{ ArenaAllocator<int32_t>(arena) };
+      for (std::size_t i = 0; i < n; i++) {
+        b.push_back(static_cast<int32_t>(i));
+      }
+      benchmark::DoNotOptimize(a.data());
+      benchmark::DoNotOptimize(b.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_ScratchArena)->Arg(100)->Arg(10000);
+
+}
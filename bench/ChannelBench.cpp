@@ -0,0 +1,254 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FakeHost.h"
+#include "Parallel.h"
+#include "TDChannels.h"
+
+using namespace tekt;
+
+namespace {
+
+  std::vector<std::string> channelNames(int64_t count) {
+    std::vector<std::string> names;
+    for (int64_t i = 0; i < count; i++) {
+      names.push_back("chan" + std::to_string(i));
+    }
+    return names;
+  }
+
+  std::vector<std::unique_ptr<FloatInChannel>> makeInputs(const std::vector<std::string>& names) {
+    std::vector<std::unique_ptr<FloatInChannel>> channels;
+    for (const auto& name : names) {
+      channels.push_back(std::make_unique<FloatInChannel>(std::array<std::string, 1>{ name }, 0.0f));
+    }
+    return channels;
+  }
+
+  void BM_ChannelMapAttachInputs(benchmark::State& state) {
+    auto names = channelNames(state.range(0));
+    FakeCHOPInput input(names, 1);
+    auto channels = makeInputs(names);
+    ChannelMap chans;
+    chans.addFromInput(input.get());
+    for (auto _ : state) {
+      for (auto& channel : channels) {
+        channel->attachInput(input.get(), chans);
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_ChannelMapAttachInputs)->Arg(10)->Arg(100)->Arg(500);
+
+  void BM_BindingAttachInputs(benchmark::State& state) {
+    auto names = channelNames(state.range(0));
+    FakeCHOPInput input(names, 1);
+    auto channels = makeInputs(names);
+    InputChannelBinding binding;
+    for (auto& channel : channels) {
+      binding.add(*channel);
+    }
+    for (auto _ : state) {
+      // Each iteration is a new cook of the input with the same layout.
+      input.cook();
+      binding.attach(input.get());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_BindingAttachInputs)->Arg(10)->Arg(100)->Arg(500);
+
+  void BM_ChannelMapAttachOutputs(benchmark::State& state) {
+    auto names = channelNames(state.range(0));
+    FakeCHOPOutput output(names, 1);
+    std::vector<std::unique_ptr<FloatOutChannel>> channels;
+    for (const auto& name : names) {
+      channels.push_back(std::make_unique<FloatOutChannel>(std::array<std::string, 1>{ name }, 0.0f));
+    }
+    ChannelMap chans;
+    for (const auto& name : names) {
+      chans.add(name);
+    }
+    for (auto _ : state) {
+      for (auto& channel : channels) {
+        channel->attachOutput(output.get(), chans);
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_ChannelMapAttachOutputs)->Arg(10)->Arg(100)->Arg(500);
+
+  void BM_BindingAttachOutputs(benchmark::State& state) {
+    auto names = channelNames(state.range(0));
+    FakeCHOPOutput output(names, 1);
+    std::vector<std::unique_ptr<FloatOutChannel>> channels;
+    OutputChannelBinding binding;
+    for (const auto& name : names) {
+      channels.push_back(std::make_unique<FloatOutChannel>(std::array<std::string, 1>{ name }, 0.0f));
+      binding.add(*channels.back());
+    }
+    for (auto _ : state) {
+      binding.attach(output.get());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_BindingAttachOutputs)->Arg(10)->Arg(100)->Arg(500);
+
+  struct VectorFixture {
+    explicit VectorFixture(int32_t numSamples)
+      : input({ "tx", "ty", "tz" }, numSamples),
+      output({ "tx", "ty", "tz" }, numSamples),
+      values(numSamples) {
+      input.fillRamp();
+      inPositions.attachInput(input.get(), inChans.addFromInput(input.get()));
+      outPositions.attachOutput(output.get(), outChans);
+    }
+
+    FakeCHOPInput input;
+    FakeCHOPOutput output;
+    ChannelMap inChans;
+    ChannelMap outChans{ "tx", "ty", "tz" };
+    VectorInChannel inPositions{ { "tx", "ty", "tz" }, Vector(0, 0, 0) };
+    VectorOutChannel outPositions{ { "tx", "ty", "tz" }, Vector(0, 0, 0) };
+    std::vector<Vector> values;
+  };
+
+  void BM_VectorInputPerSample(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    VectorFixture fixture(numSamples);
+    for (auto _ : state) {
+      for (int32_t i = 0; i < numSamples; i++) {
+        fixture.values[i] = fixture.inPositions.input(i);
+      }
+      benchmark::DoNotOptimize(fixture.values.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples);
+  }
+  BENCHMARK(BM_VectorInputPerSample)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+  void BM_VectorInputRange(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    VectorFixture fixture(numSamples);
+    for (auto _ : state) {
+      fixture.inPositions.input(0, numSamples, fixture.values.data());
+      benchmark::DoNotOptimize(fixture.values.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples);
+  }
+  BENCHMARK(BM_VectorInputRange)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+  void BM_VectorOutputPerSample(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    VectorFixture fixture(numSamples);
+    for (auto _ : state) {
+      for (int32_t i = 0; i < numSamples; i++) {
+        fixture.outPositions.output(i, fixture.values[i]);
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples);
+  }
+  BENCHMARK(BM_VectorOutputPerSample)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+  void BM_VectorOutputRange(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    VectorFixture fixture(numSamples);
+    for (auto _ : state) {
+      fixture.outPositions.output(0, numSamples, fixture.values.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples);
+  }
+  BENCHMARK(BM_VectorOutputRange)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+  // Passing through every input channel that a CHOP doesn't modify: first by
+  // looking each unused channel up by name, then with copyUnusedInputs().
+
+  void BM_PassthroughByName(benchmark::State& state) {
+    auto names = channelNames(state.range(0));
+    FakeCHOPInput input(names, 1000);
+    FakeCHOPOutput output(names, 1000);
+    input.fillRamp();
+    ChannelMap chans;
+    chans.addFromInput(input.get());
+    chans.inputData(input.get(), "chan0");
+    for (auto _ : state) {
+      for (const auto& name : chans.unusedInputNames()) {
+        auto src = chans.inputData(input.get(), name);
+        auto dest = chans.outputData(output.get(), name);
+        for (int32_t i = 0; i < 1000; i++) {
+          dest[i] = src[i];
+        }
+      }
+      benchmark::ClobberMemory();
+      // Reading marks the channels as used, so start over for the next cook.
+      state.PauseTiming();
+      chans.clear();
+      chans.addFromInput(input.get());
+      chans.inputData(input.get(), "chan0");
+      state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_PassthroughByName)->Arg(10)->Arg(100);
+
+  void BM_PassthroughCopyUnused(benchmark::State& state) {
+    auto names = channelNames(state.range(0));
+    FakeCHOPInput input(names, 1000);
+    FakeCHOPOutput output(names, 1000);
+    input.fillRamp();
+    ChannelMap chans;
+    chans.addFromInput(input.get());
+    chans.inputData(input.get(), "chan0");
+    for (auto _ : state) {
+      chans.copyUnusedInputs(input.get(), output.get());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_PassthroughCopyUnused)->Arg(10)->Arg(100);
+
+  // A per-sample update with enough math in it to be worth spreading across
+  // threads, run the way a particle CHOP would.
+  Vector integrate(const Vector& position, int32_t i) {
+    float t = static_cast<float>(i) * 0.001f;
+    return Vector(
+      position.x + std::sin(t + position.y) * 0.01f,
+      position.y + std::cos(t + position.z) * 0.01f,
+      position.z + std::sin(t * 0.5f + position.x) * 0.01f);
+  }
+
+  void BM_VectorUpdateSerial(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    VectorFixture fixture(numSamples);
+    for (auto _ : state) {
+      for (int32_t i = 0; i < numSamples; i++) {
+        fixture.outPositions.output(i, integrate(fixture.inPositions.input(i), i));
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples);
+  }
+  BENCHMARK(BM_VectorUpdateSerial)->Arg(1000)->Arg(100000)->Arg(1000000)->UseRealTime();
+
+  void BM_VectorUpdateParallel(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    VectorFixture fixture(numSamples);
+    for (auto _ : state) {
+      parallelFor(0, numSamples, [&](int32_t i) {
+        fixture.outPositions.output(i, integrate(fixture.inPositions.input(i), i));
+      });
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples);
+  }
+  BENCHMARK(BM_VectorUpdateParallel)->Arg(1000)->Arg(100000)->Arg(1000000)->UseRealTime();
+
+}
@@ -0,0 +1,406 @@
+#include "FakeHost.h"
+#include <cstring>
+
+namespace {
+  std::vector<std::vector<float>> makeData(std::size_t numChannels, int32_t numSamples) {
+    return std::vector<std::vector<float>>(numChannels, std::vector<float>(numSamples, 0.0f));
+  }
+
+  std::vector<const char*> namePointers(const std::vector<std::string>& names) {
+    std::vector<const char*> ptrs;
+    for (const auto& name : names) {
+      ptrs.push_back(name.c_str());
+    }
+    return ptrs;
+  }
+
+  template<typename P>
+  std::vector<P*> dataPointers(std::vector<std::vector<float>>& data) {
+    std::vector<P*> ptrs;
+    for (auto& channel : data) {
+      ptrs.push_back(channel.data());
+    }
+    return ptrs;
+  }
+}
+
+namespace tekt {
+
+  FakeCHOPInput::FakeCHOPInput(std::vector<std::string> names, int32_t numSamples)
+    : _names(std::move(names)),
+    _data(makeData(_names.size(), numSamples)),
+    _namePtrs(namePointers(_names)),
+    _dataPtrs(dataPointers<const float>(_data)) {
+    std::memset(&_input, 0, sizeof(_input));
+    _input.opPath = "/fake/input";
+    _input.numChannels = static_cast<int32_t>(_names.size());
+    _input.numSamples = numSamples;
+    _input.sampleRate = 60.0;
+    _input.channelData = _dataPtrs.data();
+    _input.nameData = _namePtrs.data();
+    _input.totalCooks = 1;
+  }
+
+  void FakeCHOPInput::fillRamp() {
+    for (std::size_t c = 0; c < _data.size(); c++) {
+      auto& channel = _data[c];
+      for (std::size_t i = 0; i < channel.size(); i++) {
+        channel[i] = static_cast<float>(c) + static_cast<float>(i % 1000) * 0.001f;
+      }
+    }
+  }
+
+  FakeSOPInput::FakeSOPInput() {
+    opPath = "/fake/sop";
+    opId = 2;
+    totalCooks = 1;
+    updatePointers();
+  }
+
+  void FakeSOPInput::makeGrid(int32_t columns, int32_t rows) {
+    _positions.clear();
+    for (int32_t y = 0; y <= rows; y++) {
+      for (int32_t x = 0; x <= columns; x++) {
+        _positions.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.0f);
+      }
+    }
+    _indices.clear();
+    for (int32_t y = 0; y < rows; y++) {
+      for (int32_t x = 0; x < columns; x++) {
+        auto corner = y * (columns + 1) + x;
+        int32_t quad[6] = { corner, corner + 1, corner + columns + 2, corner, corner + columns + 2, corner + columns + 1 };
+        _indices.insert(_indices.end(), quad, quad + 6);
+      }
+    }
+    _prims.assign(_indices.size() / 3, SOP_PrimitiveInfo());
+    for (std::size_t i = 0; i < _prims.size(); i++) {
+      _prims[i].numVertices = 3;
+      _prims[i].type = PrimitiveType::Polygon;
+      _prims[i].pointIndicesOffset = static_cast<int32_t>(i * 3);
+    }
+    totalCooks++;
+    updatePointers();
+  }
+
+  void FakeSOPInput::addCustomAttribute(const std::string& name, int32_t numComponents, std::vector<float> values) {
+    auto custom = std::make_unique<Custom>();
+    custom->name = name;
+    custom->floats = std::move(values);
+    custom->data = SOP_CustomAttribData(nullptr, numComponents, AttribType::Float);
+    _custom.push_back(std::move(custom));
+    updatePointers();
+  }
+
+  void FakeSOPInput::addCustomAttribute(const std::string& name, int32_t numComponents, std::vector<int32_t> values) {
+    auto custom = std::make_unique<Custom>();
+    custom->name = name;
+    custom->ints = std::move(values);
+    custom->data = SOP_CustomAttribData(nullptr, numComponents, AttribType::Int);
+    _custom.push_back(std::move(custom));
+    updatePointers();
+  }
+
+  const SOP_CustomAttribData* FakeSOPInput::getCustomAttribute(int32_t customAttribIndex) const {
+    if (customAttribIndex < 0 || customAttribIndex >= getNumCustomAttributes()) {
+      return nullptr;
+    }
+    return &_custom[customAttribIndex]->data;
+  }
+
+  const SOP_CustomAttribData* FakeSOPInput::getCustomAttribute(const char* customAttribName) const {
+    for (const auto& custom : _custom) {
+      if (custom->name == customAttribName) {
+        return &custom->data;
+      }
+    }
+    return nullptr;
+  }
+
+  void FakeSOPInput::updatePointers() {
+    for (auto& prim : _prims) {
+      prim.pointIndices = _indices.data() + prim.pointIndicesOffset;
+    }
+    myPrimsInfo = _prims.data();
+    myPrimPointIndices = _indices.data();
+    for (auto& custom : _custom) {
+      custom->data.name = custom->name.c_str();
+      custom->data.floatData = custom->floats.empty() ? nullptr : custom->floats.data();
+      custom->data.intData = custom->ints.empty() ? nullptr : custom->ints.data();
+    }
+  }
+
+  FakeCHOPOutput::FakeCHOPOutput(std::vector<std::string> names, int32_t numSamples)
+    : _names(std::move(names)),
+    _data(makeData(_names.size(), numSamples)),
+    _namePtrs(namePointers(_names)),
+    _dataPtrs(dataPointers<float>(_data)),
+    _output(static_cast<int32_t>(_names.size()), numSamples, 60.0f, 0,
+            _dataPtrs.data(), _namePtrs.data()) {}
+
+  bool FakeVBOOutput::addCustomAttribute(const SOP_CustomAttribInfo& cu) {
+    for (const auto& custom : _custom) {
+      if (custom.name == cu.name) {
+        return true;
+      }
+    }
+    _custom.push_back({ cu.name, cu.numComponents, cu.attribType, {}, {} });
+    return true;
+  }
+
+  void FakeVBOOutput::allocVBO(int32_t numVertices, int32_t numIndices, VBOBufferMode) {
+    auto n = static_cast<std::size_t>(numVertices);
+    _positions.resize(n);
+    _normals.resize(_hasNormal ? n : 0);
+    _colors.resize(_hasColor ? n : 0);
+    _texCoords.resize(n * static_cast<std::size_t>(_texCoordLayers));
+    for (auto& custom : _custom) {
+      auto size = n * static_cast<std::size_t>(custom.numComponents);
+      custom.floats.resize(custom.type == AttribType::Float ? size : 0);
+      custom.ints.resize(custom.type == AttribType::Int ? size : 0);
+    }
+    _indices.resize(static_cast<std::size_t>(numIndices));
+    _usedIndices = 0;
+    _complete = false;
+  }
+
+  bool FakeVBOOutput::getCustomAttribute(SOP_CustomAttribData* cu, const char* name) {
+    if (cu == nullptr || name == nullptr) {
+      return false;
+    }
+    for (const auto& custom : _custom) {
+      if (custom.name == name) {
+        *cu = SOP_CustomAttribData(custom.name.c_str(), custom.numComponents, custom.type);
+        cu->floatData = custom.floats.empty() ? nullptr : custom.floats.data();
+        cu->intData = custom.ints.empty() ? nullptr : custom.ints.data();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int32_t* FakeVBOOutput::addIndices(int32_t count) {
+    assert(_usedIndices + static_cast<std::size_t>(count) <= _indices.size());
+    auto result = _indices.data() + _usedIndices;
+    _usedIndices += static_cast<std::size_t>(count);
+    return result;
+  }
+
+  int32_t FakeSOPOutput::addPoint(const Position& pos) {
+    _positions.push_back(pos);
+    return static_cast<int32_t>(_positions.size()) - 1;
+  }
+
+  bool FakeSOPOutput::addPoints(const Position* pos, int32_t numPoints) {
+    _positions.insert(_positions.end(), pos, pos + numPoints);
+    return true;
+  }
+
+  bool FakeSOPOutput::setNormal(const Vector& n, int32_t pointIdx) {
+    return setNormals(&n, 1, pointIdx);
+  }
+
+  bool FakeSOPOutput::setNormals(const Vector* n, int32_t numPoints, int32_t startPointIdx) {
+    if (startPointIdx < 0 || startPointIdx + numPoints > getNumPoints()) {
+      return false;
+    }
+    _normals.resize(_positions.size());
+    std::copy_n(n, numPoints, _normals.begin() + startPointIdx);
+    return true;
+  }
+
+  bool FakeSOPOutput::setColor(const Color& c, int32_t pointIdx) {
+    return setColors(&c, 1, pointIdx);
+  }
+
+  bool FakeSOPOutput::setColors(const Color* colors, int32_t numPoints, int32_t startPointIdx) {
+    if (startPointIdx < 0 || startPointIdx + numPoints > getNumPoints()) {
+      return false;
+    }
+    _colors.resize(_positions.size());
+    std::copy_n(colors, numPoints, _colors.begin() + startPointIdx);
+    return true;
+  }
+
+  bool FakeSOPOutput::setTexCoord(const TexCoord* tex, int32_t numLayers, int32_t pointIdx) {
+    return setTexCoords(tex, 1, numLayers, pointIdx);
+  }
+
+  bool FakeSOPOutput::setTexCoords(const TexCoord* t, int32_t numPoints, int32_t numLayers, int32_t startPointIdx) {
+    if (numLayers != 1 || startPointIdx < 0 || startPointIdx + numPoints > getNumPoints()) {
+      return false;
+    }
+    _texCoords.resize(_positions.size());
+    std::copy_n(t, numPoints, _texCoords.begin() + startPointIdx);
+    return true;
+  }
+
+  bool FakeSOPOutput::setCustomAttribute(const SOP_CustomAttribData* cu, int32_t numPoints) {
+    if (cu == nullptr || cu->name == nullptr || numPoints > getNumPoints()) {
+      return false;
+    }
+    auto& values = _custom[cu->name];
+    auto count = static_cast<std::size_t>(numPoints) * static_cast<std::size_t>(cu->numComponents);
+    values.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+      values[i] = cu->attribType == AttribType::Float ? cu->floatData[i] : static_cast<float>(cu->intData[i]);
+    }
+    return true;
+  }
+
+  void FakeSOPOutput::clear() {
+    _positions.clear();
+    _normals.clear();
+    _colors.clear();
+    _texCoords.clear();
+    _custom.clear();
+  }
+
+  const std::vector<float>* FakeSOPOutput::custom(const std::string& name) const {
+    auto iter = _custom.find(name);
+    return iter == _custom.end() ? nullptr : &iter->second;
+  }
+
+  OP_ParAppendResult FakeParameterManager::append(const OP_NumericParameter& np, int32_t size) {
+    Definition def;
+    def.name = np.name;
+    def.page = np.page == nullptr ? "" : np.page;
+    def.size = size;
+    for (int i = 0; i < 4; i++) {
+      def.defaultValues[i] = np.defaultValues[i];
+    }
+    def.isString = false;
+    _definitions.push_back(std::move(def));
+    return OP_ParAppendResult::Success;
+  }
+
+  OP_ParAppendResult FakeParameterManager::append(const OP_StringParameter& sp) {
+    Definition def;
+    def.name = sp.name;
+    def.page = sp.page == nullptr ? "" : sp.page;
+    def.size = 1;
+    for (double& v : def.defaultValues) {
+      v = 0;
+    }
+    def.defaultString = sp.defaultValue == nullptr ? "" : sp.defaultValue;
+    def.isString = true;
+    _definitions.push_back(std::move(def));
+    return OP_ParAppendResult::Success;
+  }
+
+  FakeInputs::FakeInputs() {
+    std::memset(&_timeInfo, 0, sizeof(_timeInfo));
+    _timeInfo.rate = 60.0;
+    _timeInfo.rootRate = 60.0;
+    _timeInfo.deltaFrames = 1.0;
+    _timeInfo.deltaMS = 1000.0 / 60.0;
+  }
+
+  void FakeInputs::addParameters(const FakeParameterManager& manager) {
+    for (const auto& def : manager.definitions()) {
+      auto& par = value(def.name);
+      for (int i = 0; i < 4; i++) {
+        par.values[i] = def.defaultValues[i];
+      }
+      par.str = def.defaultString;
+    }
+  }
+
+  void FakeInputs::setPar(const std::string& name, double v0, double v1, double v2, double v3) {
+    auto& par = value(name);
+    par.values[0] = v0;
+    par.values[1] = v1;
+    par.values[2] = v2;
+    par.values[3] = v3;
+  }
+
+  void FakeInputs::setPar(const std::string& name, const std::string& value) {
+    this->value(name).str = value;
+  }
+
+  const OP_CHOPInput* FakeInputs::getInputCHOP(int32_t index) const {
+    if (index < 0 || index >= getNumInputs()) return nullptr;
+    return _chopInputs[index];
+  }
+
+  FakeInputs::Value& FakeInputs::value(const std::string& name) {
+    auto iter = _values.find(name);
+    if (iter != _values.end()) return iter->second;
+    _names.push_back(name);
+    return _values[_names.back()];
+  }
+
+  const FakeInputs::Value* FakeInputs::find(const char* name) const {
+    auto iter = _values.find(std::string_view(name));
+    if (iter == _values.end()) return nullptr;
+    return &iter->second;
+  }
+
+  double FakeInputs::getParDouble(const char* name, int32_t index) const {
+    auto value = find(name);
+    return value == nullptr ? 0.0 : value->values[index];
+  }
+
+  bool FakeInputs::getParDouble2(const char* name, double& v0, double& v1) const {
+    auto value = find(name);
+    if (value == nullptr) return false;
+    v0 = value->values[0];
+    v1 = value->values[1];
+    return true;
+  }
+
+  bool FakeInputs::getParDouble3(const char* name, double& v0, double& v1, double& v2) const {
+    auto value = find(name);
+    if (value == nullptr) return false;
+    v0 = value->values[0];
+    v1 = value->values[1];
+    v2 = value->values[2];
+    return true;
+  }
+
+  bool FakeInputs::getParDouble4(const char* name, double& v0, double& v1, double& v2, double& v3) const {
+    auto value = find(name);
+    if (value == nullptr) return false;
+    v0 = value->values[0];
+    v1 = value->values[1];
+    v2 = value->values[2];
+    v3 = value->values[3];
+    return true;
+  }
+
+  int32_t FakeInputs::getParInt(const char* name, int32_t index) const {
+    return static_cast<int32_t>(getParDouble(name, index));
+  }
+
+  bool FakeInputs::getParInt2(const char* name, int32_t& v0, int32_t& v1) const {
+    double d0, d1;
+    if (!getParDouble2(name, d0, d1)) return false;
+    v0 = static_cast<int32_t>(d0);
+    v1 = static_cast<int32_t>(d1);
+    return true;
+  }
+
+  bool FakeInputs::getParInt3(const char* name, int32_t& v0, int32_t& v1, int32_t& v2) const {
+    double d0, d1, d2;
+    if (!getParDouble3(name, d0, d1, d2)) return false;
+    v0 = static_cast<int32_t>(d0);
+    v1 = static_cast<int32_t>(d1);
+    v2 = static_cast<int32_t>(d2);
+    return true;
+  }
+
+  bool FakeInputs::getParInt4(const char* name, int32_t& v0, int32_t& v1, int32_t& v2, int32_t& v3) const {
+    double d0, d1, d2, d3;
+    if (!getParDouble4(name, d0, d1, d2, d3)) return false;
+    v0 = static_cast<int32_t>(d0);
+    v1 = static_cast<int32_t>(d1);
+    v2 = static_cast<int32_t>(d2);
+    v3 = static_cast<int32_t>(d3);
+    return true;
+  }
+
+  const char* FakeInputs::getParString(const char* name) const {
+    auto value = find(name);
+    return value == nullptr ? "" : value->str.c_str();
+  }
+
+}
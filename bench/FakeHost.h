@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "CHOP_CPlusPlusBase.h"
+#include "SOP_CPlusPlusBase.h"
+
+// In-process stand-ins for the objects that TouchDesigner passes to a custom
+// OP, so that the library can be exercised headless.
+
+namespace tekt {
+
+  /// A CHOP input that owns its channel names and sample data.
+  class FakeCHOPInput {
+  public:
+    FakeCHOPInput(std::vector<std::string> names, int32_t numSamples);
+
+    /// Fills every channel with a deterministic ramp of values.
+    void fillRamp();
+
+    /// Simulates the input cooking again, with the same channel layout.
+    void cook() { _input.totalCooks++; }
+
+    float* channel(int32_t i) { return _data[i].data(); }
+
+    const OP_CHOPInput* get() const { return &_input; }
+  private:
+    std::vector<std::string> _names;
+    std::vector<std::vector<float>> _data;
+    std::vector<const char*> _namePtrs;
+    std::vector<const float*> _dataPtrs;
+    OP_CHOPInput _input;
+  };
+
+  /// A SOP input that owns its points, triangles and custom attributes.
+  class FakeSOPInput : public OP_SOPInput {
+  public:
+    FakeSOPInput();
+
+    /// Replaces the geometry with a grid of columns x rows unit quads in the
+    /// XY plane, each split into two triangles.
+    void makeGrid(int32_t columns, int32_t rows);
+
+    void addCustomAttribute(const std::string& name, int32_t numComponents, std::vector<float> values);
+    void addCustomAttribute(const std::string& name, int32_t numComponents, std::vector<int32_t> values);
+
+    /// Simulates the input cooking again, with the same geometry.
+    void cook() { totalCooks++; }
+
+    int32_t getNumPoints() const override { return static_cast<int32_t>(_positions.size()); }
+    int32_t getNumVertices() const override { return static_cast<int32_t>(_indices.size()); }
+    int32_t getNumPrimitives() const override { return static_cast<int32_t>(_prims.size()); }
+    int32_t getNumCustomAttributes() const override { return static_cast<int32_t>(_custom.size()); }
+    const Position* getPointPositions() const override { return _positions.data(); }
+    const SOP_NormalInfo* getNormals() const override { return nullptr; }
+    const SOP_ColorInfo* getColors() const override { return nullptr; }
+    const SOP_TextureInfo* getTextures() const override { return nullptr; }
+    const SOP_CustomAttribData* getCustomAttribute(int32_t customAttribIndex) const override;
+    const SOP_CustomAttribData* getCustomAttribute(const char* customAttribName) const override;
+    bool hasNormals() const override { return false; }
+    bool hasColors() const override { return false; }
+  private:
+    struct Custom {
+      std::string name;
+      std::vector<float> floats;
+      std::vector<int32_t> ints;
+      SOP_CustomAttribData data;
+    };
+
+    void updatePointers();
+
+    std::vector<Position> _positions;
+    std::vector<int32_t> _indices;
+    std::vector<SOP_PrimitiveInfo> _prims;
+    std::vector<std::unique_ptr<Custom>> _custom;
+  };
+
+  /// Output channel storage, and a CHOP_Output that refers to it.
+  class FakeCHOPOutput {
+  public:
+    FakeCHOPOutput(std::vector<std::string> names, int32_t numSamples);
+
+    float* channel(int32_t i) { return _data[i].data(); }
+
+    CHOP_Output* get() { return &_output; }
+  private:
+    std::vector<std::string> _names;
+    std::vector<std::vector<float>> _data;
+    std::vector<const char*> _namePtrs;
+    std::vector<float*> _dataPtrs;
+    CHOP_Output _output;
+  };
+
+  /// VBO storage that is resized on each allocVBO(). Unlike the host's, its
+  /// contents aren't cleared, so benchmarks only measure the writes.
+  class FakeVBOOutput : public SOP_VBOOutput {
+  public:
+    void enableNormal() override { _hasNormal = true; }
+    void enableColor() override { _hasColor = true; }
+    void enableTexCoord(int32_t numLayers = 0) override { _texCoordLayers = std::max(numLayers, 1); }
+    bool hasNormal() override { return _hasNormal; }
+    bool hasColor() override { return _hasColor; }
+    bool hasTexCoord() override { return _texCoordLayers > 0; }
+    bool hasCustomAttibutes() override { return !_custom.empty(); }
+    bool addCustomAttribute(const SOP_CustomAttribInfo& cu) override;
+    void allocVBO(int32_t numVertices, int32_t numIndices, VBOBufferMode mode) override;
+    Position* getPos() override { return _positions.data(); }
+    Vector* getNormals() override { return _hasNormal ? _normals.data() : nullptr; }
+    Color* getColors() override { return _hasColor ? _colors.data() : nullptr; }
+    TexCoord* getTexCoords() override { return _texCoordLayers > 0 ? _texCoords.data() : nullptr; }
+    int32_t getNumTexCoordLayers() override { return _texCoordLayers; }
+    int32_t* addTriangles(int32_t numTriangles) override { return addIndices(numTriangles * 3); }
+    int32_t* addParticleSystem(int32_t numParticles) override { return addIndices(numParticles); }
+    int32_t* addLines(int32_t numIndices) override { return addIndices(numIndices); }
+    bool getCustomAttribute(SOP_CustomAttribData* cu, const char* name) override;
+    void updateComplete() override { _complete = true; }
+    bool setBoundingBox(const BoundingBox& bbox) override { _bounds = bbox; return true; }
+
+    const std::vector<int32_t>& indices() const { return _indices; }
+    const BoundingBox& bounds() const { return _bounds; }
+    bool isComplete() const { return _complete; }
+  private:
+    struct Custom {
+      std::string name;
+      int32_t numComponents;
+      AttribType type;
+      std::vector<float> floats;
+      std::vector<int32_t> ints;
+    };
+
+    int32_t* addIndices(int32_t count);
+
+    bool _hasNormal = false;
+    bool _hasColor = false;
+    int32_t _texCoordLayers = 0;
+    std::vector<Custom> _custom;
+    std::vector<Position> _positions;
+    std::vector<Vector> _normals;
+    std::vector<Color> _colors;
+    std::vector<TexCoord> _texCoords;
+    std::vector<int32_t> _indices;
+    std::size_t _usedIndices = 0;
+    BoundingBox _bounds { 0, 0, 0, 0, 0, 0 };
+    bool _complete = false;
+  };
+
+  /// Point attribute storage for a SOP's execute(), with the per-point
+  /// methods as well as the bulk ones.
+  class FakeSOPOutput : public SOP_Output {
+  public:
+    int32_t addPoint(const Position& pos) override;
+    bool addPoints(const Position* pos, int32_t numPoints) override;
+    int32_t getNumPoints() override { return static_cast<int32_t>(_positions.size()); }
+    bool setNormal(const Vector& n, int32_t pointIdx) override;
+    bool setNormals(const Vector* n, int32_t numPoints, int32_t startPointIdx) override;
+    bool hasNormal() override { return !_normals.empty(); }
+    bool setColor(const Color& c, int32_t pointIdx) override;
+    bool setColors(const Color* colors, int32_t numPoints, int32_t startPointIdx) override;
+    bool hasColor() override { return !_colors.empty(); }
+    bool setTexCoord(const TexCoord* tex, int32_t numLayers, int32_t pointIdx) override;
+    bool setTexCoords(const TexCoord* t, int32_t numPoints, int32_t numLayers, int32_t startPointIdx) override;
+    bool hasTexCoord() override { return !_texCoords.empty(); }
+    int32_t getNumTexCoordLayers() override { return hasTexCoord() ? 1 : 0; }
+    bool setCustomAttribute(const SOP_CustomAttribData* cu, int32_t numPoints) override;
+    bool hasCustomAttibutes() override { return !_custom.empty(); }
+    bool addTriangle(int32_t, int32_t, int32_t) override { return true; }
+    bool addTriangles(const int32_t*, int32_t) override { return true; }
+    bool addParticleSystem(int32_t, int32_t) override { return true; }
+    bool addLine(const int32_t*, int32_t) override { return true; }
+    bool addLines(const int32_t*, int32_t*, int32_t) override { return true; }
+    int32_t getNumPrimitives() override { return 0; }
+    bool setBoundingBox(const BoundingBox&) override { return true; }
+    bool addGroup(const SOP_GroupType&, const char*) override { return true; }
+    bool destroyGroup(const SOP_GroupType&, const char*) override { return true; }
+    bool addPointToGroup(int, const char*) override { return true; }
+    bool addPrimToGroup(int, const char*) override { return true; }
+    bool addToGroup(int, const SOP_GroupType&, const char*) override { return true; }
+    bool discardFromPointGroup(int, const char*) override { return true; }
+    bool discardFromPrimGroup(int, const char*) override { return true; }
+    bool discardFromGroup(int, const SOP_GroupType&, const char*) override { return true; }
+
+    /// Removes every point, keeping the storage.
+    void clear();
+
+    const std::vector<Position>& positions() const { return _positions; }
+    const std::vector<Vector>& normals() const { return _normals; }
+    const std::vector<Color>& colors() const { return _colors; }
+    const std::vector<TexCoord>& texCoords() const { return _texCoords; }
+    /// The values of a custom attribute, converted to floats.
+    const std::vector<float>* custom(const std::string& name) const;
+  private:
+    std::vector<Position> _positions;
+    std::vector<Vector> _normals;
+    std::vector<Color> _colors;
+    std::vector<TexCoord> _texCoords;
+    std::unordered_map<std::string, std::vector<float>> _custom;
+  };
+
+  class FakeString : public OP_String {
+  public:
+    void setString(const char* val) override { value = val; }
+
+    std::string value;
+  };
+
+  /// Records the parameters that are appended, without doing anything else
+  /// with them.
+  class FakeParameterManager : public OP_ParameterManager {
+  public:
+    struct Definition {
+      std::string name;
+      std::string page;
+      int32_t size;
+      double defaultValues[4];
+      std::string defaultString;
+      bool isString;
+    };
+
+    OP_ParAppendResult appendFloat(const OP_NumericParameter& np, int32_t size = 1) override { return append(np, size); }
+    OP_ParAppendResult appendInt(const OP_NumericParameter& np, int32_t size = 1) override { return append(np, size); }
+    OP_ParAppendResult appendXY(const OP_NumericParameter& np) override { return append(np, 2); }
+    OP_ParAppendResult appendXYZ(const OP_NumericParameter& np) override { return append(np, 3); }
+    OP_ParAppendResult appendUV(const OP_NumericParameter& np) override { return append(np, 2); }
+    OP_ParAppendResult appendUVW(const OP_NumericParameter& np) override { return append(np, 3); }
+    OP_ParAppendResult appendRGB(const OP_NumericParameter& np) override { return append(np, 3); }
+    OP_ParAppendResult appendRGBA(const OP_NumericParameter& np) override { return append(np, 4); }
+    OP_ParAppendResult appendToggle(const OP_NumericParameter& np) override { return append(np, 1); }
+    OP_ParAppendResult appendPulse(const OP_NumericParameter& np) override { return append(np, 1); }
+    OP_ParAppendResult appendString(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendFile(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendFolder(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendDAT(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendCHOP(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendTOP(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendObject(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendMenu(const OP_StringParameter& sp, int32_t,
+                                  const char**, const char**) override {
+      return append(sp);
+    }
+    OP_ParAppendResult appendStringMenu(const OP_StringParameter& sp, int32_t,
+                                        const char**, const char**) override {
+      return append(sp);
+    }
+    OP_ParAppendResult appendSOP(const OP_StringParameter& sp) override { return append(sp); }
+    OP_ParAppendResult appendPython(const OP_StringParameter& sp) override { return append(sp); }
+
+    const std::vector<Definition>& definitions() const { return _definitions; }
+    void clear() { _definitions.clear(); }
+  private:
+    OP_ParAppendResult append(const OP_NumericParameter& np, int32_t size);
+    OP_ParAppendResult append(const OP_StringParameter& sp);
+
+    std::vector<Definition> _definitions;
+  };
+
+  /// Parameter values and inputs, looked up by name the way the host does.
+  class FakeInputs : public OP_Inputs {
+  public:
+    FakeInputs();
+
+    /// Adds every parameter that was appended to the manager, set to its
+    /// default value.
+    void addParameters(const FakeParameterManager& manager);
+    void setPar(const std::string& name, double v0, double v1 = 0, double v2 = 0, double v3 = 0);
+    void setPar(const std::string& name, const std::string& value);
+    void addInput(const FakeCHOPInput& input) { _chopInputs.push_back(input.get()); }
+
+    OP_TimeInfo& timeInfo() { return _timeInfo; }
+
+    int32_t getNumInputs() const override { return static_cast<int32_t>(_chopInputs.size()); }
+    const OP_TOPInput* getInputTOP(int32_t) const override { return nullptr; }
+    const OP_CHOPInput* getInputCHOP(int32_t index) const override;
+    const OP_DATInput* getParDAT(const char*) const override { return nullptr; }
+    const OP_TOPInput* getParTOP(const char*) const override { return nullptr; }
+    const OP_CHOPInput* getParCHOP(const char*) const override { return nullptr; }
+    const OP_ObjectInput* getParObject(const char*) const override { return nullptr; }
+    double getParDouble(const char* name, int32_t index = 0) const override;
+    bool getParDouble2(const char* name, double& v0, double& v1) const override;
+    bool getParDouble3(const char* name, double& v0, double& v1, double& v2) const override;
+    bool getParDouble4(const char* name, double& v0, double& v1, double& v2, double& v3) const override;
+    int32_t getParInt(const char* name, int32_t index = 0) const override;
+    bool getParInt2(const char* name, int32_t& v0, int32_t& v1) const override;
+    bool getParInt3(const char* name, int32_t& v0, int32_t& v1, int32_t& v2) const override;
+    bool getParInt4(const char* name, int32_t& v0, int32_t& v1, int32_t& v2, int32_t& v3) const override;
+    const char* getParString(const char* name) const override;
+    const char* getParFilePath(const char* name) const override { return getParString(name); }
+    bool getRelativeTransform(const char*, const char*, double[4][4]) const override { return false; }
+    void enablePar(const char*, bool) const override {}
+    const OP_DATInput* getDAT(const char*) const override { return nullptr; }
+    const OP_TOPInput* getTOP(const char*) const override { return nullptr; }
+    const OP_CHOPInput* getCHOP(const char*) const override { return nullptr; }
+    const OP_ObjectInput* getObject(const char*) const override { return nullptr; }
+    void* getTOPDataInCPUMemory(const OP_TOPInput*, const OP_TOPInputDownloadOptions*) const override { return nullptr; }
+    const OP_SOPInput* getParSOP(const char*) const override { return nullptr; }
+    const OP_SOPInput* getInputSOP(int32_t) const override { return nullptr; }
+    const OP_SOPInput* getSOP(const char*) const override { return nullptr; }
+    const OP_DATInput* getInputDAT(int32_t) const override { return nullptr; }
+    PyObject* getParPython(const char*) const override { return nullptr; }
+    const OP_TimeInfo* getTimeInfo() const override { return &_timeInfo; }
+  private:
+    struct Value {
+      double values[4] = { 0, 0, 0, 0 };
+      std::string str;
+    };
+
+    const Value* find(const char* name) const;
+    Value& value(const std::string& name);
+
+    // Keyed by views of the strings in _names, so that lookups from the
+    // OP_Inputs functions don't allocate.
+    std::unordered_map<std::string_view, Value> _values;
+    std::deque<std::string> _names;
+    std::vector<const OP_CHOPInput*> _chopInputs;
+    OP_TimeInfo _timeInfo;
+  };
+
+}
@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "FakeHost.h"
+#include "TDGeometry.h"
+
+using namespace tekt;
+
+namespace {
+
+  const std::vector<std::string> names = { "tx", "ty", "tz", "nx", "ny", "nz", "r", "g", "b", "a" };
+
+  // Instanced quads, with 4 vertices and 2 triangles for each input sample.
+  void fillQuadIndices(int32_t* indices, int32_t numQuads) {
+    for (int32_t q = 0; q < numQuads; q++) {
+      auto v = q * 4;
+      int32_t* tri = indices + q * 6;
+      tri[0] = v; tri[1] = v + 1; tri[2] = v + 2;
+      tri[3] = v; tri[4] = v + 2; tri[5] = v + 3;
+    }
+  }
+
+  struct PointChannels {
+    PointChannels() : input(names, 1) {}
+
+    explicit PointChannels(int32_t numSamples) : input(names, numSamples) {
+      input.fillRamp();
+      chans.addFromInput(input.get());
+      positions.attachInput(input.get(), chans);
+      normals.attachInput(input.get(), chans);
+      colors.attachInput(input.get(), chans);
+    }
+
+    FakeCHOPInput input;
+    ChannelMap chans;
+    VectorInChannel positions { { "tx", "ty", "tz" }, Vector(0, 0, 0) };
+    VectorInChannel normals { { "nx", "ny", "nz" }, Vector(0, 0, 1) };
+    ColorInChannel colors { { "r", "g", "b", "a" }, Color(1, 1, 1, 1) };
+  };
+
+  // The hand-written version, reading each point through the channels and
+  // regenerating the indices every cook.
+  void BM_GeometryPerPoint(benchmark::State& state) {
+    auto numPoints = static_cast<int32_t>(state.range(0));
+    PointChannels points(numPoints);
+    FakeVBOOutput output;
+    for (auto _ : state) {
+      output.enableNormal();
+      output.enableColor();
+      output.allocVBO(numPoints, numPoints, VBOBufferMode::Dynamic);
+      auto pos = output.getPos();
+      auto normals = output.getNormals();
+      auto colors = output.getColors();
+      for (int32_t i = 0; i < numPoints; i++) {
+        auto p = points.positions.input(i);
+        pos[i] = Position(p.x, p.y, p.z);
+        normals[i] = points.normals.input(i);
+        colors[i] = points.colors.input(i);
+      }
+      auto indices = output.addParticleSystem(numPoints);
+      for (int32_t i = 0; i < numPoints; i++) {
+        indices[i] = i;
+      }
+      output.updateComplete();
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numPoints);
+  }
+  BENCHMARK(BM_GeometryPerPoint)->Arg(1000)->Arg(100000);
+
+  void BM_GeometryBuilder(benchmark::State& state) {
+    auto numPoints = static_cast<int32_t>(state.range(0));
+    PointChannels points(numPoints);
+    FakeVBOOutput output;
+    GeometryBuilder builder;
+    builder.withNormals().withColors();
+    for (auto _ : state) {
+      builder.begin(&output, numPoints, numPoints);
+      builder.setPositions(0, numPoints, points.positions);
+      builder.setNormals(0, numPoints, points.normals);
+      builder.setColors(0, numPoints, points.colors);
+      builder.addParticleSystem(numPoints);
+      builder.end();
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numPoints);
+  }
+  BENCHMARK(BM_GeometryBuilder)->Arg(1000)->Arg(100000);
+
+  void BM_GeometryQuadsPerCook(benchmark::State& state) {
+    auto numQuads = static_cast<int32_t>(state.range(0));
+    FakeVBOOutput output;
+    for (auto _ : state) {
+      output.allocVBO(numQuads * 4, numQuads * 6, VBOBufferMode::Dynamic);
+      fillQuadIndices(output.addTriangles(numQuads * 2), numQuads);
+      output.updateComplete();
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numQuads);
+  }
+  BENCHMARK(BM_GeometryQuadsPerCook)->Arg(1000)->Arg(100000);
+
+  void BM_GeometryQuadsCached(benchmark::State& state) {
+    auto numQuads = static_cast<int32_t>(state.range(0));
+    FakeVBOOutput output;
+    GeometryBuilder builder;
+    for (auto _ : state) {
+      builder.begin(&output, numQuads * 4, numQuads * 6);
+      builder.addTriangles(numQuads * 2, [&](int32_t* indices) { fillQuadIndices(indices, numQuads); });
+      builder.end();
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numQuads);
+  }
+  BENCHMARK(BM_GeometryQuadsCached)->Arg(1000)->Arg(100000);
+
+  // Point clouds written to a SOP_Output one point at a time.
+  void BM_PointsPerPoint(benchmark::State& state) {
+    auto numPoints = static_cast<int32_t>(state.range(0));
+    PointChannels points(numPoints);
+    FakeSOPOutput output;
+    for (auto _ : state) {
+      output.clear();
+      for (int32_t i = 0; i < numPoints; i++) {
+        auto p = points.positions.input(i);
+        output.addPoint(Position(p.x, p.y, p.z));
+        output.setNormal(points.normals.input(i), i);
+        output.setColor(points.colors.input(i), i);
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numPoints);
+  }
+  BENCHMARK(BM_PointsPerPoint)->Arg(1000)->Arg(1000000);
+
+  void BM_PointsWriter(benchmark::State& state) {
+    auto numPoints = static_cast<int32_t>(state.range(0));
+    PointChannels points(numPoints);
+    FakeSOPOutput output;
+    PointWriter writer;
+    for (auto _ : state) {
+      output.clear();
+      auto first = writer.addPoints(&output, points.positions, numPoints);
+      writer.setNormals(&output, points.normals, first, numPoints);
+      writer.setColors(&output, points.colors, first, numPoints);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numPoints);
+  }
+  BENCHMARK(BM_PointsWriter)->Arg(1000)->Arg(1000000);
+
+}
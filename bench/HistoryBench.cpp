@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FakeHost.h"
+#include "TDChannelHistory.h"
+
+using namespace tekt;
+
+namespace {
+
+  // Ten seconds of history at 60 samples per second, for a few channels,
+  // with a timeslice of a few samples each cook.
+  constexpr int32_t historyLength = 600;
+  constexpr int32_t timesliceLength = 4;
+  const std::vector<std::string> names = { "tx", "ty", "tz", "r", "g", "b", "a" };
+
+  // Keeping the history in plain arrays and shifting them every cook.
+  void BM_HistoryShiftArrays(benchmark::State& state) {
+    FakeCHOPInput input(names, timesliceLength);
+    input.fillRamp();
+    std::vector<std::vector<float>> history(names.size(), std::vector<float>(historyLength));
+    for (auto _ : state) {
+      for (std::size_t c = 0; c < names.size(); c++) {
+        auto& samples = history[c];
+        std::move(samples.begin() + timesliceLength, samples.end(), samples.begin());
+        std::copy_n(input.channel(static_cast<int32_t>(c)), timesliceLength, samples.end() - timesliceLength);
+      }
+      benchmark::ClobberMemory();
+    }
+  }
+  BENCHMARK(BM_HistoryShiftArrays);
+
+  void BM_HistoryAppend(benchmark::State& state) {
+    FakeCHOPInput input(names, timesliceLength);
+    input.fillRamp();
+    ChannelMap chans;
+    chans.addFromInput(input.get());
+    std::vector<std::unique_ptr<FloatInChannel>> channels;
+    ChannelHistory history(historyLength);
+    for (const auto& name : names) {
+      channels.push_back(std::make_unique<FloatInChannel>(std::array<std::string, 1>{ name }, 0.0f));
+      channels.back()->attachInput(input.get(), chans);
+      history.track(*channels.back());
+    }
+    for (auto _ : state) {
+      history.append(input.get());
+      benchmark::ClobberMemory();
+    }
+  }
+  BENCHMARK(BM_HistoryAppend);
+
+}
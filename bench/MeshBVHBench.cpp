@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <string>
+#include <vector>
+#include "FakeHost.h"
+#include "TDMeshBVH.h"
+
+using namespace tekt;
+
+namespace {
+
+  const int32_t gridSize = 100;
+  const std::vector<std::string> names = { "tx", "ty", "tz", "dx", "dy", "dz" };
+
+  // Rays pointing down at a gridSize x gridSize grid of quads, from above
+  // points spread over it.
+  struct Rays {
+    explicit Rays(int32_t count) : input(names, count) {
+      for (int32_t i = 0; i < count; i++) {
+        input.channel(0)[i] = static_cast<float>((i * 37) % 1000) * 0.1f;
+        input.channel(1)[i] = static_cast<float>((i * 91) % 1000) * 0.1f;
+        input.channel(2)[i] = 1.0f;
+        input.channel(3)[i] = 0.0f;
+        input.channel(4)[i] = 0.0f;
+        input.channel(5)[i] = -1.0f;
+      }
+      chans.addFromInput(input.get());
+      origins.attachInput(input.get(), chans);
+      directions.attachInput(input.get(), chans);
+      hits.resize(static_cast<std::size_t>(count));
+      points.resize(static_cast<std::size_t>(count));
+    }
+
+    FakeCHOPInput input;
+    ChannelMap chans;
+    VectorInChannel origins { { "tx", "ty", "tz" }, Vector(0, 0, 0) };
+    VectorInChannel directions { { "dx", "dy", "dz" }, Vector(0, 0, -1) };
+    std::vector<RayHit> hits;
+    std::vector<SurfacePoint> points;
+  };
+
+  Vector cross(const Vector& a, const Vector& b) {
+    return Vector(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+  }
+
+  // Tests every triangle of the input for every ray.
+  void BM_RaycastBruteForce(benchmark::State& state) {
+    FakeSOPInput sop;
+    sop.makeGrid(gridSize, gridSize);
+    Rays rays(static_cast<int32_t>(state.range(0)));
+    const auto* positions = sop.getPointPositions();
+    for (auto _ : state) {
+      int32_t found = 0;
+      for (int32_t i = 0; i < state.range(0); i++) {
+        auto o = rays.origins.input(i);
+        auto d = rays.directions.input(i);
+        auto best = std::numeric_limits<float>::infinity();
+        for (int32_t p = 0; p < sop.getNumPrimitives(); p++) {
+          const auto* tri = sop.myPrimsInfo[p].pointIndices;
+          Vector e1(positions[tri[1]].x - positions[tri[0]].x, positions[tri[1]].y - positions[tri[0]].y,
+                    positions[tri[1]].z - positions[tri[0]].z);
+          Vector e2(positions[tri[2]].x - positions[tri[0]].x, positions[tri[2]].y - positions[tri[0]].y,
+                    positions[tri[2]].z - positions[tri[0]].z);
+          auto pv = cross(d, e2);
+          auto det = e1.dot(pv);
+          if (det == 0.0f) {
+            continue;
+          }
+          Vector s(o.x - positions[tri[0]].x, o.y - positions[tri[0]].y, o.z - positions[tri[0]].z);
+          auto u = s.dot(pv) / det;
+          auto qv = cross(s, e1);
+          auto v = d.dot(qv) / det;
+          auto t = e2.dot(qv) / det;
+          if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t < best) {
+            best = t;
+          }
+        }
+        found += best < std::numeric_limits<float>::infinity() ? 1 : 0;
+      }
+      benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void BM_RaycastBVH(benchmark::State& state) {
+    FakeSOPInput sop;
+    sop.makeGrid(gridSize, gridSize);
+    Rays rays(static_cast<int32_t>(state.range(0)));
+    MeshBVH bvh;
+    for (auto _ : state) {
+      bvh.update(&sop);
+      bvh.intersect(rays.origins, rays.directions, static_cast<int32_t>(state.range(0)), rays.hits.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void BM_ClosestPointsBVH(benchmark::State& state) {
+    FakeSOPInput sop;
+    sop.makeGrid(gridSize, gridSize);
+    Rays rays(static_cast<int32_t>(state.range(0)));
+    MeshBVH bvh;
+    for (auto _ : state) {
+      bvh.update(&sop);
+      bvh.closestPoints(rays.origins, static_cast<int32_t>(state.range(0)), rays.points.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // Rebuilds the tree on every iteration, as when the input cooks each frame.
+  void BM_BVHBuild(benchmark::State& state) {
+    FakeSOPInput sop;
+    sop.makeGrid(gridSize, gridSize);
+    MeshBVH bvh;
+    for (auto _ : state) {
+      sop.cook();
+      bvh.update(&sop);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * sop.getNumPrimitives());
+  }
+
+}
+
+BENCHMARK(BM_RaycastBruteForce)->Arg(100);
+BENCHMARK(BM_RaycastBVH)->Arg(100)->Arg(10000);
+BENCHMARK(BM_ClosestPointsBVH)->Arg(100)->Arg(10000);
+BENCHMARK(BM_BVHBuild);
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FakeHost.h"
+#include "TDSettings.h"
+
+using namespace tekt;
+
+namespace {
+
+  /// A group with a mix of parameter types, similar to a typical OP page.
+  class MixedParams : public ParamGroup {
+  public:
+    MixedParams(int groupIndex, int count)
+      : ParamGroup("Page" + std::to_string(groupIndex)) {
+      for (int i = 0; i < count; i++) {
+        auto name = "Par" + std::to_string(groupIndex) + "x" + std::to_string(i);
+        switch (i % 5) {
+          case 0:
+            _params.push_back(std::make_unique<FloatParameter>(name, name, FloatOpts(0.5f, 0.0f, 1.0f)));
+            break;
+          case 1:
+            _params.push_back(std::make_unique<IntParameter>(name, name, IntOpts(3, 0, 10)));
+            break;
+          case 2:
+            _params.push_back(std::make_unique<BoolParameter>(name, name, true));
+            break;
+          case 3:
+            _params.push_back(std::make_unique<StringParameter>(name, name, "some default value"));
+            break;
+          default:
+            _params.push_back(std::make_unique<VectorParameter>(name, name, FloatOptsArray<3>(FloatOpts(0.0f, -1.0f, 1.0f))));
+            break;
+        }
+        add(*_params.back());
+      }
+      auto pulseName = "Pulse" + std::to_string(groupIndex);
+      _pulse = std::make_unique<PulseParameter>(pulseName, pulseName);
+      add(*_pulse);
+    }
+  private:
+    std::vector<std::unique_ptr<Parameter>> _params;
+    std::unique_ptr<PulseParameter> _pulse;
+  };
+
+  class BenchSettings : public Settings {
+  public:
+    explicit BenchSettings(int count) {
+      static constexpr int perGroup = 10;
+      for (int g = 0; g * perGroup < count; g++) {
+        _groups.push_back(std::make_unique<MixedParams>(g, std::min(perGroup, count - g * perGroup)));
+        add(*_groups.back());
+      }
+    }
+  private:
+    std::vector<std::unique_ptr<MixedParams>> _groups;
+  };
+
+  void BM_SettingsCreate(benchmark::State& state) {
+    BenchSettings settings(static_cast<int>(state.range(0)));
+    FakeParameterManager manager;
+    for (auto _ : state) {
+      manager.clear();
+      settings.create(&manager);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_SettingsCreate)->Arg(10)->Arg(100)->Arg(300);
+
+  void BM_SettingsCreateFromTable(benchmark::State& state) {
+    BenchSettings settings(static_cast<int>(state.range(0)));
+    FakeParameterManager manager;
+    ParTable table;
+    for (auto _ : state) {
+      manager.clear();
+      settings.create(&manager, table);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_SettingsCreateFromTable)->Arg(10)->Arg(100)->Arg(300);
+
+  void BM_SettingsLoad(benchmark::State& state) {
+    BenchSettings settings(static_cast<int>(state.range(0)));
+    FakeParameterManager manager;
+    settings.create(&manager);
+    FakeInputs inputs;
+    inputs.addParameters(manager);
+    for (auto _ : state) {
+      settings.load(inputs);
+      benchmark::DoNotOptimize(settings.hasChanged());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_SettingsLoad)->Arg(10)->Arg(100)->Arg(300);
+
+  void BM_SettingsHandlePulse(benchmark::State& state) {
+    auto count = static_cast<int>(state.range(0));
+    BenchSettings settings(count);
+    std::vector<std::string> pulseNames;
+    for (int g = 0; g * 10 < count; g++) {
+      pulseNames.push_back("Pulse" + std::to_string(g));
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(settings.handlePulse(pulseNames[i].c_str()));
+      i = (i + 1) % pulseNames.size();
+    }
+  }
+  BENCHMARK(BM_SettingsHandlePulse)->Arg(10)->Arg(100)->Arg(300);
+
+}
@@ -0,0 +1,164 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "FakeHost.h"
+#include "TDChannelSchema.h"
+#include "TDParticlePool.h"
+
+using namespace tekt;
+
+namespace {
+
+  struct Particle {
+    int id;
+    Vector position;
+    Color color;
+  };
+
+  const std::vector<std::string> outputNames = {
+    "id", "tx", "ty", "tz", "r", "g", "b", "a",
+  };
+
+  // The hand-rolled pattern: particles in a vector of structs, written out
+  // sample by sample through OutputChannels.
+  void BM_ParticlesVectorOfStructs(benchmark::State& state) {
+    auto numParticles = static_cast<int32_t>(state.range(0));
+    FakeCHOPOutput output(outputNames, numParticles);
+    ChannelMap chans{ "id", "tx", "ty", "tz", "r", "g", "b", "a" };
+    OutputChannel<int> ids{ { "id" }, -1 };
+    OutputChannel<Vector> positions{ { "tx", "ty", "tz" }, Vector(0, 0, 0) };
+    OutputChannel<Color> colors{ { "r", "g", "b", "a" }, Color(0, 0, 0, 0) };
+    std::vector<Particle> particles(numParticles);
+    for (int32_t i = 0; i < numParticles; i++) {
+      particles[i] = { i, Vector(1, 2, 3), Color(1, 1, 1, 1) };
+    }
+    for (auto _ : state) {
+      ids.attachOutput(output.get(), chans);
+      positions.attachOutput(output.get(), chans);
+      colors.attachOutput(output.get(), chans);
+      for (int32_t i = 0; i < numParticles; i++) {
+        ids.output(i, particles[i].id);
+        positions.output(i, particles[i].position);
+        colors.output(i, particles[i].color);
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numParticles);
+  }
+  BENCHMARK(BM_ParticlesVectorOfStructs)->Arg(1000)->Arg(100000);
+
+  struct IdField : ChannelField<int> {
+    static constexpr const char* names[] = { "id" };
+    static int defaults() { return -1; }
+  };
+  struct PositionField : ChannelField<Vector> {
+    static constexpr const char* names[] = { "tx", "ty", "tz" };
+    static Vector defaults() { return Vector(0, 0, 0); }
+  };
+  struct ColorField : ChannelField<Color> {
+    static constexpr const char* names[] = { "r", "g", "b", "a" };
+    static Color defaults() { return Color(0, 0, 0, 0); }
+  };
+  using ParticleSchema = ChannelSchema<IdField, PositionField, ColorField>;
+
+  // The same per-sample writes, through a compile-time schema.
+  void BM_ParticlesSchema(benchmark::State& state) {
+    auto numParticles = static_cast<int32_t>(state.range(0));
+    FakeCHOPOutput output(outputNames, numParticles);
+    ParticleSchema::Output out;
+    std::vector<Particle> particles(numParticles);
+    for (int32_t i = 0; i < numParticles; i++) {
+      particles[i] = { i, Vector(1, 2, 3), Color(1, 1, 1, 1) };
+    }
+    for (auto _ : state) {
+      out.attach(output.get());
+      for (int32_t i = 0; i < numParticles; i++) {
+        out.set<IdField>(i, particles[i].id);
+        out.set<PositionField>(i, particles[i].position);
+        out.set<ColorField>(i, particles[i].color);
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numParticles);
+  }
+  BENCHMARK(BM_ParticlesSchema)->Arg(1000)->Arg(100000);
+
+  // Clearing every slot to the defaults, per sample through the virtual
+  // outputDefault(), and in bulk through an OutputChannelSet.
+
+  void BM_OutputDefaultVirtual(benchmark::State& state) {
+    auto numParticles = static_cast<int32_t>(state.range(0));
+    FakeCHOPOutput output(outputNames, numParticles);
+    ChannelMap chans{ "id", "tx", "ty", "tz", "r", "g", "b", "a" };
+    OutputChannel<int> ids{ { "id" }, -1 };
+    OutputChannel<Vector> positions{ { "tx", "ty", "tz" }, Vector(0, 0, 0) };
+    OutputChannel<Color> colors{ { "r", "g", "b", "a" }, Color(0, 0, 0, 0) };
+    std::vector<OutputChannelBase*> channels{ &ids, &positions, &colors };
+    for (auto _ : state) {
+      for (auto channel : channels) {
+        channel->attachOutput(output.get(), chans);
+      }
+      for (int32_t i = 0; i < numParticles; i++) {
+        for (auto channel : channels) {
+          channel->outputDefault(i);
+        }
+      }
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numParticles);
+  }
+  BENCHMARK(BM_OutputDefaultVirtual)->Arg(1000)->Arg(100000);
+
+  void BM_OutputChannelSetFillDefaults(benchmark::State& state) {
+    auto numParticles = static_cast<int32_t>(state.range(0));
+    FakeCHOPOutput output(outputNames, numParticles);
+    OutputChannel<int> ids{ { "id" }, -1 };
+    OutputChannel<Vector> positions{ { "tx", "ty", "tz" }, Vector(0, 0, 0) };
+    OutputChannel<Color> colors{ { "r", "g", "b", "a" }, Color(0, 0, 0, 0) };
+    OutputChannelSet channels{ ids, positions, colors };
+    for (auto _ : state) {
+      channels.attach(output.get());
+      channels.fillDefaults(0, numParticles);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numParticles);
+  }
+  BENCHMARK(BM_OutputChannelSetFillDefaults)->Arg(1000)->Arg(100000);
+
+  void BM_ParticlePoolFlush(benchmark::State& state) {
+    auto numParticles = static_cast<int32_t>(state.range(0));
+    FakeCHOPOutput output(outputNames, numParticles);
+    ParticlePool pool(numParticles);
+    auto ids = pool.addField<int>({ "id" }, -1);
+    auto positions = pool.addField<Vector>({ "tx", "ty", "tz" }, Vector(0, 0, 0));
+    auto colors = pool.addField<Color>({ "r", "g", "b", "a" }, Color(0, 0, 0, 0));
+    for (int32_t i = 0; i < numParticles; i++) {
+      auto slot = pool.spawn();
+      ids.set(slot, i);
+      positions.set(slot, Vector(1, 2, 3));
+      colors.set(slot, Color(1, 1, 1, 1));
+    }
+    for (auto _ : state) {
+      pool.flush(output.get());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numParticles);
+  }
+  BENCHMARK(BM_ParticlePoolFlush)->Arg(1000)->Arg(100000);
+
+  void BM_ParticlePoolSpawnKill(benchmark::State& state) {
+    ParticlePool pool(4096);
+    pool.addField<int>({ "id" }, -1);
+    pool.addField<Vector>({ "tx", "ty", "tz" }, Vector(0, 0, 0));
+    for (int32_t i = 0; i < 2048; i++) {
+      pool.spawn();
+    }
+    int32_t victim = 0;
+    for (auto _ : state) {
+      pool.kill(victim);
+      benchmark::DoNotOptimize(pool.spawn());
+      victim = (victim + 7) % 2048;
+    }
+  }
+  BENCHMARK(BM_ParticlePoolSpawnKill);
+
+}
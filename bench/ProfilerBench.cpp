@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "FakeHost.h"
+#include "TDProfiler.h"
+
+using namespace tekt;
+
+namespace {
+
+  void BM_ProfilerScope(benchmark::State& state) {
+    Profiler profiler;
+    auto& section = profiler.section("execute");
+    for (auto _ : state) {
+      Profiler::Scope scope(section);
+      benchmark::ClobberMemory();
+    }
+  }
+  BENCHMARK(BM_ProfilerScope);
+
+  void BM_ProfilerScopeByName(benchmark::State& state) {
+    Profiler profiler;
+    for (auto _ : state) {
+      Profiler::Scope scope(profiler, "channels.attach");
+      benchmark::ClobberMemory();
+    }
+  }
+  BENCHMARK(BM_ProfilerScopeByName);
+
+  void BM_ProfilerPublishInfoCHOP(benchmark::State& state) {
+    Profiler profiler;
+    for (auto name : { "params.load", "channels.attach", "execute" }) {
+      auto& section = profiler.section(name);
+      for (int i = 0; i < 200; i++) {
+        section.record(1000 + i * 37 % 500);
+      }
+    }
+    FakeString name;
+    OP_InfoCHOPChan chan;
+    chan.name = &name;
+    for (auto _ : state) {
+      // A new sample each cook, so the statistics are recomputed.
+      profiler.section("execute").record(1234);
+      for (int32_t i = 0; i < profiler.getNumInfoCHOPChans(); i++) {
+        profiler.getInfoCHOPChan(i, &chan);
+      }
+      benchmark::DoNotOptimize(chan.value);
+    }
+  }
+  BENCHMARK(BM_ProfilerPublishInfoCHOP);
+
+}
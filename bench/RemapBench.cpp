@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "TektCommon.h"
+#include "ValueRange.h"
+
+namespace {
+
+  void BM_RemapScalar(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<float> input(count);
+    std::vector<float> output(count);
+    for (std::size_t i = 0; i < count; i++) {
+      input[i] = static_cast<float>(i % 1000) * 0.01f;
+    }
+    for (auto _ : state) {
+      for (std::size_t i = 0; i < count; i++) {
+        output[i] = tekt::remap(input[i], 0.0f, 10.0f, -1.0f, 1.0f, true);
+      }
+      benchmark::DoNotOptimize(output.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_RemapScalar)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+  void BM_RemapArray(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<float> input(count);
+    std::vector<float> output(count);
+    for (std::size_t i = 0; i < count; i++) {
+      input[i] = static_cast<float>(i % 1000) * 0.01f;
+    }
+    for (auto _ : state) {
+      tekt::remap(input.data(), output.data(), count, 0.0f, 10.0f, -1.0f, 1.0f, true);
+      benchmark::DoNotOptimize(output.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_RemapArray)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+  void BM_RemapVectorArray(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<float> input(count);
+    std::vector<Vector> output(count);
+    for (std::size_t i = 0; i < count; i++) {
+      input[i] = static_cast<float>(i % 1000) * 0.01f;
+    }
+    Vector low(0, 0, 0);
+    Vector high(1, 2, 3);
+    for (auto _ : state) {
+      tekt::remap(input.data(), output.data(), count, 0.0f, 10.0f, low, high);
+      benchmark::DoNotOptimize(output.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_RemapVectorArray)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+  void BM_ValueRangeCheckAndNormalize(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<float> input(count);
+    std::vector<float> output(count);
+    for (std::size_t i = 0; i < count; i++) {
+      input[i] = static_cast<float>(i % 1000) * 0.01f;
+    }
+    tekt::ValueRange<float> range(0.0f, 10.0f);
+    for (auto _ : state) {
+      for (std::size_t i = 0; i < count; i++) {
+        range.checkAndNormalize(input[i], &output[i]);
+      }
+      benchmark::DoNotOptimize(output.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_ValueRangeCheckAndNormalize)->Arg(1000)->Arg(100000);
+
+  void BM_ValueRangeMapperNormalize(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<float> input(count);
+    std::vector<float> output(count);
+    for (std::size_t i = 0; i < count; i++) {
+      input[i] = static_cast<float>(i % 1000) * 0.01f;
+    }
+    tekt::ValueRangeMapper<float> mapper(0.0f, 10.0f);
+    for (auto _ : state) {
+      mapper.normalize(input.data(), output.data(), count, true);
+      benchmark::DoNotOptimize(output.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_ValueRangeMapperNormalize)->Arg(1000)->Arg(100000);
+
+}
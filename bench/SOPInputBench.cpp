@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "FakeHost.h"
+#include "TDSOPInput.h"
+
+using namespace tekt;
+
+namespace {
+
+  // A grid with a few custom attributes ahead of the ones that are read, as
+  // an input from a typical network would have.
+  struct SOPInput {
+    explicit SOPInput(int32_t size) {
+      input.makeGrid(size, size);
+      auto numPoints = static_cast<std::size_t>(input.getNumPoints());
+      for (const char* name : { "Tex", "N", "Cd", "pscale", "id" }) {
+        input.addCustomAttribute(std::string("extra_") + name, 1, std::vector<float>(numPoints, 0.0f));
+      }
+      input.addCustomAttribute("weight", 1, std::vector<float>(numPoints, 0.5f));
+      input.addCustomAttribute("velocity", 3, std::vector<float>(numPoints * 3, 1.0f));
+    }
+
+    FakeSOPInput input;
+  };
+
+  // Looks up each attribute by name on every cook, and reads each point
+  // through it.
+  void BM_SOPAttributesByName(benchmark::State& state) {
+    SOPInput sop(static_cast<int32_t>(state.range(0)));
+    for (auto _ : state) {
+      sop.input.cook();
+      auto weight = sop.input.getCustomAttribute("weight");
+      auto velocity = sop.input.getCustomAttribute("velocity");
+      auto positions = sop.input.getPointPositions();
+      float sum = 0.0f;
+      for (int32_t i = 0; i < sop.input.getNumPoints(); i++) {
+        float w = weight != nullptr && weight->attribType == AttribType::Float ? weight->floatData[i] : 1.0f;
+        float v = velocity != nullptr && velocity->numComponents == 3 ? velocity->floatData[i * 3 + 1] : 0.0f;
+        sum += positions[i].y * w + v;
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * sop.input.getNumPoints());
+  }
+
+  void BM_SOPAttributesReader(benchmark::State& state) {
+    SOPInput sop(static_cast<int32_t>(state.range(0)));
+    FloatSOPAttribute weight { "weight", 1.0f };
+    VectorSOPAttribute velocity { "velocity", Vector(0, 0, 0) };
+    SOPInputReader reader { &weight, &velocity };
+    for (auto _ : state) {
+      sop.input.cook();
+      reader.attach(&sop.input);
+      auto positions = reader.positions();
+      auto weights = weight.values();
+      auto velocities = velocity.values();
+      float sum = 0.0f;
+      for (int32_t i = 0; i < reader.numPoints(); i++) {
+        sum += positions[i].y * weights[i] + velocities[i].y;
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * sop.input.getNumPoints());
+  }
+
+}
+
+BENCHMARK(BM_SOPAttributesByName)->Arg(8)->Arg(256);
+BENCHMARK(BM_SOPAttributesReader)->Arg(8)->Arg(256);
@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "TDSpatialGrid.h"
+
+using namespace tekt;
+
+namespace {
+
+  // Particles spread through a unit cube, each looking for the others
+  // within a radius that finds around 20 neighbors.
+  std::vector<Position> makeParticles(int32_t count) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<Position> points(static_cast<std::size_t>(count));
+    for (auto& p : points) {
+      p = Position(dist(rng), dist(rng), dist(rng));
+    }
+    return points;
+  }
+
+  float neighborRadius(int32_t count) {
+    return std::cbrt(20.0f / (4.19f * static_cast<float>(count)));
+  }
+
+  void BM_NeighborsBruteForce(benchmark::State& state) {
+    auto count = static_cast<int32_t>(state.range(0));
+    auto points = makeParticles(count);
+    auto radius = neighborRadius(count);
+    for (auto _ : state) {
+      int32_t total = 0;
+      for (int32_t i = 0; i < count; i++) {
+        for (int32_t j = 0; j < count; j++) {
+          auto dx = points[i].x - points[j].x;
+          auto dy = points[i].y - points[j].y;
+          auto dz = points[i].z - points[j].z;
+          total += dx * dx + dy * dy + dz * dz <= radius * radius ? 1 : 0;
+        }
+      }
+      benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+  }
+
+  void BM_NeighborsGrid(benchmark::State& state) {
+    auto count = static_cast<int32_t>(state.range(0));
+    auto points = makeParticles(count);
+    auto radius = neighborRadius(count);
+    SpatialGrid grid(radius);
+    for (auto _ : state) {
+      grid.build(points.data(), count);
+      int32_t total = 0;
+      for (auto i : grid.order()) {
+        grid.forEachInRadius(points[i], radius, [&](int32_t, float) { total++; });
+      }
+      benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+  }
+
+  void BM_NearestGrid(benchmark::State& state) {
+    auto count = static_cast<int32_t>(state.range(0));
+    auto points = makeParticles(count);
+    SpatialGrid grid(neighborRadius(count));
+    Neighbor nearest[8];
+    for (auto _ : state) {
+      grid.build(points.data(), count);
+      float total = 0.0f;
+      for (auto i : grid.order()) {
+        grid.findNearest(points[i], 8, nearest, i);
+        total += nearest[7].distanceSquared;
+      }
+      benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+  }
+
+  void BM_GridBuild(benchmark::State& state) {
+    auto count = static_cast<int32_t>(state.range(0));
+    auto points = makeParticles(count);
+    SpatialGrid grid(neighborRadius(count));
+    for (auto _ : state) {
+      grid.build(points.data(), count);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+  }
+
+  void BM_GridBuildParallel(benchmark::State& state) {
+    auto count = static_cast<int32_t>(state.range(0));
+    auto points = makeParticles(count);
+    SpatialGrid grid(neighborRadius(count));
+    for (auto _ : state) {
+      grid.buildParallel(points.data(), count);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+  }
+
+}
+
+BENCHMARK(BM_NeighborsBruteForce)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_NeighborsGrid)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_NearestGrid)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_GridBuild)->Arg(10000)->Arg(1000000);
+BENCHMARK(BM_GridBuildParallel)->Arg(10000)->Arg(1000000);
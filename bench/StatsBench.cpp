@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "FakeHost.h"
+#include "TDChannelStats.h"
+
+using namespace tekt;
+
+namespace {
+
+  const std::vector<std::string> names = { "tx", "ty", "tz" };
+
+  // A separate loop over the samples for each statistic.
+  void BM_StatsSeparateLoops(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    FakeCHOPInput input(names, numSamples);
+    input.fillRamp();
+    for (auto _ : state) {
+      for (int32_t c = 0; c < input.get()->numChannels; c++) {
+        auto data = input.channel(c);
+        auto lo = *std::min_element(data, data + numSamples);
+        auto hi = *std::max_element(data, data + numSamples);
+        double sum = 0.0;
+        for (int32_t i = 0; i < numSamples; i++) {
+          sum += data[i];
+        }
+        double mean = sum / numSamples;
+        double m2 = 0.0;
+        for (int32_t i = 0; i < numSamples; i++) {
+          m2 += (data[i] - mean) * (data[i] - mean);
+        }
+        benchmark::DoNotOptimize(lo);
+        benchmark::DoNotOptimize(hi);
+        benchmark::DoNotOptimize(mean);
+        benchmark::DoNotOptimize(std::sqrt(mean * mean + m2 / numSamples));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples * static_cast<int64_t>(names.size()));
+  }
+  BENCHMARK(BM_StatsSeparateLoops)->Arg(600)->Arg(48000);
+
+  void BM_StatsChannelMap(benchmark::State& state) {
+    auto numSamples = static_cast<int32_t>(state.range(0));
+    FakeCHOPInput input(names, numSamples);
+    input.fillRamp();
+    ChannelMap chans;
+    chans.addFromInput(input.get());
+    std::vector<ChannelStats> results;
+    for (auto _ : state) {
+      inputChannelStats(input.get(), chans, results);
+      benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples * static_cast<int64_t>(names.size()));
+  }
+  BENCHMARK(BM_StatsChannelMap)->Arg(600)->Arg(48000);
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// Stand-in for macOS's <OpenGL/gltypes.h>, which CPlusPlus_Common.h includes
+// on every non-Windows platform. This lets the library and its benchmarks be
+// built headless on Linux. It is only put on the include path by CMake when
+// building for a platform other than Windows or macOS.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int GLenum;
+typedef int GLint;
+typedef unsigned int GLuint;
+
+// The plugin entry point typedefs in the OP base headers use __cdecl, which
+// only exists on Windows and macOS toolchains.
+#ifndef __cdecl
+  #define __cdecl
+#endif
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include "FakeHost.h"
+#include "TDSettings.h"
+
+using namespace tekt;
+
+// Checks are made without assert() so that they still run in release builds.
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (false)
+
+namespace {
+
+  int failures = 0;
+
+  /// A parameter that loads its value directly, without going through
+  /// update(), as subclasses written before change tracking do.
+  class DirectParameter final : public Parameter {
+  public:
+    DirectParameter(std::string n, std::string l)
+      : Parameter(std::move(n), std::move(l)) {}
+
+    void create(ParBuilder& pars) const override {
+      pars.addFloat({ name, label }, FloatOpts(0.0f, 0.0f, 1.0f));
+    }
+    void load(const OP_Inputs& inputs) override {
+      value = static_cast<float>(inputs.getParDouble(name.c_str()));
+    }
+    float get() const { return value; }
+  private:
+    float value = 0.0f;
+  };
+
+  class TestParams : public ParamGroup {
+  public:
+    TestParams() : ParamGroup("Test") {
+      add(direct);
+      add(amount);
+    }
+    DirectParameter direct { "Direct", "Direct" };
+    FloatParameter amount { "Amount", "Amount", FloatOpts(0.5f, 0.0f, 1.0f) };
+  };
+
+  class TestSettings : public Settings {
+  public:
+    TestSettings() { add(params); }
+    TestParams params;
+  };
+
+  class BuiltInParams : public ParamGroup {
+  public:
+    BuiltInParams() : ParamGroup("Test") { add(amount); }
+    FloatParameter amount { "Amount", "Amount", FloatOpts(0.5f, 0.0f, 1.0f) };
+  };
+
+  void testDirectParameterAlwaysChanges() {
+    TestSettings settings;
+    FakeParameterManager manager;
+    settings.create(&manager);
+    FakeInputs inputs;
+    inputs.addParameters(manager);
+
+    for (int i = 0; i < 3; i++) {
+      settings.load(inputs);
+      CHECK(settings.params.direct.hasChanged());
+      CHECK(settings.params.hasChanged());
+      CHECK(settings.hasChanged());
+    }
+    CHECK(!settings.params.amount.hasChanged());
+  }
+
+  void testBuiltInParameterTracksChanges() {
+    BuiltInParams params;
+    FakeParameterManager manager;
+    params.create(&manager);
+    FakeInputs inputs;
+    inputs.addParameters(manager);
+
+    params.load(inputs);
+    CHECK(params.amount.hasChanged());
+    params.load(inputs);
+    CHECK(!params.amount.hasChanged());
+    CHECK(!params.hasChanged());
+    inputs.setPar("Amount", 0.75);
+    params.load(inputs);
+    CHECK(params.amount.hasChanged());
+    CHECK(params.hasChanged());
+  }
+
+}
+
+int main() {
+  testDirectParameterAlwaysChanges();
+  testBuiltInParameterTracksChanges();
+  if (failures != 0) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("All checks passed\n");
+  return 0;
+}